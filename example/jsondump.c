@@ -1,8 +1,12 @@
 #include "../jsmn2.h"
 #include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
 #include <unistd.h>
 
 /* Function realloc_it() is a wrapper function for standard realloc()
@@ -21,128 +25,279 @@ static inline void *realloc_it(void *ptrmem, size_t size) {
 }
 
 /*
- * An example of reading JSON from stdin and printing its content to stdout.
- * The output looks like YAML, but I'm not sure if it's really compatible.
+ * An example of reading JSON from a file or stdin and printing its content
+ * to stdout. The output looks like YAML, but I'm not sure if it's really
+ * compatible.
+ *
+ * Regular files are mapped into memory, anything else (pipes, terminals)
+ * is read into a growing buffer. The tokens are sized with a counting pass
+ * so the document is parsed exactly once, and all output goes through one
+ * large buffer.
  */
 
-static int dump(const char *js, jsmntok_t *t, size_t count, int indent) {
-  int i, j, k;
-  jsmntok_t *key;
+#define OUTBUF_SIZE (1 << 20)
+
+struct input {
+  char *js;
+  size_t len;
+  int mapped;
+};
+
+static int write_stdout(void *ctx, const char *data, size_t len) {
+  (void)ctx;
+  while (len > 0) {
+    ssize_t n = write(STDOUT_FILENO, data, len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    data += n;
+    len -= n;
+  }
+  return 0;
+}
+
+static int read_input(int fd, struct input *in) {
+  struct stat st;
+  size_t cap = 0;
+
+  in->js = NULL;
+  in->len = 0;
+  in->mapped = 0;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    /* Private and writable so that -m can minify in place */
+    void *p = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                   fd, 0);
+    if (p != MAP_FAILED) {
+      (void)madvise(p, st.st_size, MADV_SEQUENTIAL);
+      in->js = p;
+      in->len = st.st_size;
+      in->mapped = 1;
+      return 0;
+    }
+  }
+
+  for (;;) {
+    ssize_t n;
+    if (in->len == cap) {
+      cap = cap ? cap * 2 : 1 << 16;
+      in->js = realloc_it(in->js, cap);
+      if (in->js == NULL) {
+        return 3;
+      }
+    }
+    n = read(fd, in->js + in->len, cap - in->len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      fprintf(stderr, "read(): errno=%d\n", errno);
+      free(in->js);
+      return 1;
+    }
+    if (n == 0) {
+      return 0;
+    }
+    in->len += n;
+  }
+}
+
+static void free_input(struct input *in) {
+  if (in->mapped) {
+    munmap(in->js, in->len);
+  } else {
+    free(in->js);
+  }
+}
+
+/* The dump output: the first write error stops all further writes */
+struct output {
+  jsmn_sink sink;
+  int err;
+};
+
+static void put(struct output *out, const char *s, size_t len) {
+  if (out->err == JSMN_SUCCESS) {
+    out->err = jsmn_sink_write(&out->sink, s, len);
+  }
+}
+
+static void put_indent(struct output *out, int n) {
+  static const char spaces[] = "                                ";
+  for (n *= 2; n > 0; n -= (int)sizeof(spaces) - 1) {
+    put(out, spaces, n < (int)sizeof(spaces) - 1 ? (size_t)n
+                                                 : sizeof(spaces) - 1);
+  }
+}
+
+static int dump(struct output *out, const char *js, jsmntok_t *t, size_t count,
+                int indent) {
+  int i, j;
   if (count == 0) {
     return 0;
   }
   if (t->type == JSMN_PRIMITIVE) {
-    printf("%.*s", t->size, js + t->start);
+    put(out, js + t->start, t->size);
     return 1;
   } else if (t->type == JSMN_STRING) {
-    printf("'%.*s'", t->size, js + t->start);
+    put(out, "'", 1);
+    put(out, js + t->start, t->size);
+    put(out, "'", 1);
     return 1;
   } else if (t->type == JSMN_OBJECT) {
-    printf("\n");
+    put(out, "\n", 1);
     j = 0;
     for (i = 0; i < t->size; i++) {
-      for (k = 0; k < indent; k++) {
-        printf("  ");
-      }
-      key = t + 1 + j;
-      j += dump(js, key, count - j, indent + 1);
-      if (key->size > 0) {
-        printf(": ");
-        j += dump(js, t + 1 + j, count - j, indent + 1);
-      }
-      printf("\n");
+      put_indent(out, indent);
+      j += dump(out, js, t + 1 + j, count - j, indent + 1);
+      /* Every key is followed by its value */
+      put(out, ": ", 2);
+      j += dump(out, js, t + 1 + j, count - j, indent + 1);
+      put(out, "\n", 1);
     }
     return j + 1;
   } else if (t->type == JSMN_ARRAY) {
     j = 0;
-    printf("\n");
+    put(out, "\n", 1);
     for (i = 0; i < t->size; i++) {
-      for (k = 0; k < indent - 1; k++) {
-        printf("  ");
-      }
-      printf("   - ");
-      j += dump(js, t + 1 + j, count - j, indent + 1);
-      printf("\n");
+      put_indent(out, indent - 1);
+      put(out, "   - ", 5);
+      j += dump(out, js, t + 1 + j, count - j, indent + 1);
+      put(out, "\n", 1);
     }
     return j + 1;
   }
   return 0;
 }
 
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr, "usage: %s [-m | -p] [-i indent] [-t] [file]\n", prog);
+}
+
 int main(int argc, char **argv) {
-  int r;
-  int eof_expected = 0;
-  char *js = NULL;
-  size_t jslen = 0;
-  char buf[BUFSIZ];
-  FILE *fp = NULL;
+  int r, fd = STDIN_FILENO;
+  int mode = 0, report = 0;
+  const char *indent = "  ";
+  struct input in;
+  size_t n, tokcount = 0;
+  double t0, t1, t2;
+  char *outbuf;
+  struct output out;
 
   jsmn_parser p;
-  jsmntok_t *tok;
-  size_t tokcount = 2;
+  jsmntok_t *tok = NULL;
 
-  if (argc > 1) {
-    fp = fopen(argv[1], "r");
-    if (fp == NULL) {
-      printf("Error: failed to open file %s\n", argv[1]);
-      return -1;
+  while ((r = getopt(argc, argv, "mpi:t")) != -1) {
+    switch (r) {
+    case 'm':
+    case 'p':
+      mode = r;
+      break;
+    case 'i':
+      indent = optarg;
+      break;
+    case 't':
+      report = 1;
+      break;
+    default:
+      usage(argv[0]);
+      return EXIT_FAILURE;
     }
-  } else {
-    fp = stdin;
   }
 
-  /* Prepare parser */
-  jsmn_init(&p);
+  if (optind < argc) {
+    fd = open(argv[optind], O_RDONLY);
+    if (fd < 0) {
+      printf("Error: failed to open file %s\n", argv[optind]);
+      return -1;
+    }
+  }
 
-  /* Allocate some tokens as a start */
-  tok = malloc(sizeof(*tok) * tokcount);
-  if (tok == NULL) {
+  t0 = now();
+  r = read_input(fd, &in);
+  if (fd != STDIN_FILENO) {
+    close(fd);
+  }
+  if (r != 0) {
+    return r;
+  }
+  outbuf = malloc(OUTBUF_SIZE);
+  if (outbuf == NULL) {
     fprintf(stderr, "malloc(): errno=%d\n", errno);
+    free_input(&in);
     return 3;
   }
+  jsmn_sink_init(&out.sink, outbuf, OUTBUF_SIZE, write_stdout, NULL);
+  out.err = JSMN_SUCCESS;
 
-  for (;;) {
-    /* Read another chunk */
-    r = fread(buf, 1, sizeof(buf), fp);
-    if (r < 0) {
-      fprintf(stderr, "fread(): %d, errno=%d\n", r, errno);
-      return 1;
+  t1 = now();
+  if (mode == 'm') {
+    r = jsmn_minify(in.js, in.len, in.js, &n);
+    if (r == JSMN_SUCCESS) {
+      r = jsmn_sink_write(&out.sink, in.js, n);
     }
-    if (r == 0) {
-      if (eof_expected != 0) {
-        return 0;
-      } else {
-        fprintf(stderr, "fread(): unexpected EOF\n");
-        return 2;
-      }
+  } else if (mode == 'p') {
+    r = jsmn_prettify(in.js, in.len, &out.sink, indent);
+    if (r == JSMN_SUCCESS) {
+      r = jsmn_sink_write(&out.sink, "\n", 1);
     }
-
-    js = realloc_it(js, jslen + r + 1);
-    if (js == NULL) {
+  } else {
+    /* Size the token array with a counting pass, then parse once */
+    tokcount = jsmn_count_tokens(in.js, in.len);
+    tok = malloc(sizeof(*tok) * (tokcount ? tokcount : 1));
+    if (tok == NULL) {
+      fprintf(stderr, "malloc(): errno=%d\n", errno);
+      free(outbuf);
+      free_input(&in);
       return 3;
     }
-    strncpy(js + jslen, buf, r);
-    jslen = jslen + r;
-
-  again:
-    r = jsmn_parse(&p, js, jslen, tok, tokcount);
+    jsmn_init(&p);
+    r = jsmn_parse(&p, in.js, in.len, tok, tokcount);
     if (r < 0) {
-      if (r == JSMN_ERROR_NOMEM) {
-        tokcount = tokcount * 2;
-        tok = realloc_it(tok, sizeof(*tok) * tokcount);
-        if (tok == NULL) {
-          return 3;
-        }
-        goto again;
-      } else {
-        printf("jsmn_parse: %d, loc=%d:%d(%d)\n", r, p.line, p.col, p.pos);
-        return EXIT_FAILURE;
-      }
-    } else {
-      dump(js, tok, p.toknext, 0);
-      eof_expected = 1;
+      printf("jsmn_parse: %d, loc=%d:%d(%d)\n", r, (int)p.line, (int)p.col,
+             (int)p.pos);
+      free(tok);
+      free(outbuf);
+      free_input(&in);
+      return EXIT_FAILURE;
+    }
+    if (p.toknext == 0) {
+      /* Empty or whitespace-only input */
+      fprintf(stderr, "jsmn_parse: unexpected EOF\n");
+      free(tok);
+      free(outbuf);
+      free_input(&in);
+      return 2;
     }
+    tokcount = p.toknext;
+    dump(&out, in.js, tok, tokcount, 0);
+    r = out.err;
+  }
+  if (r == JSMN_SUCCESS) {
+    r = jsmn_sink_flush(&out.sink);
+  }
+  t2 = now();
+
+  if (r != JSMN_SUCCESS) {
+    fprintf(stderr, "jsondump: %d\n", r);
+  } else if (report) {
+    fprintf(stderr,
+            "%zu bytes, %zu tokens: read %.3f s, processed %.3f s "
+            "(%.1f MB/s)\n",
+            in.len, tokcount, t1 - t0, t2 - t1,
+            in.len / (t2 - t1 > 0 ? t2 - t1 : 1e-9) / 1e6);
   }
 
-  return EXIT_SUCCESS;
+  free(tok);
+  free(outbuf);
+  free_input(&in);
+  return r == JSMN_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,388 @@
+#include "../jsmn2.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * An example of overlapping reading with tokenizing. A reader thread fills
+ * fixed-size chunks from a file descriptor and hands them to the parser
+ * through a single-producer/single-consumer ring. The parser feeds each
+ * chunk to jsmn_parse_iov() as soon as it arrives, so nothing is ever
+ * concatenated, and hands chunks it no longer needs back through a second
+ * ring to be filled again. Neither side takes a lock: the rings only use
+ * acquire/release atomics, and a side that finds its ring empty or full
+ * yields the CPU.
+ *
+ * The input is a stream of JSON documents, such as NDJSON or a single
+ * document. Each document is counted once complete, then its tokens and
+ * the chunks holding it are released.
+ *
+ * With -s the input is instead read into one growing buffer the way
+ * jsondump reads pipes, then parsed: the baseline for -t.
+ */
+
+#define CHUNK_SIZE (256 << 10)
+#define RING_SIZE 64 /* a power of two */
+
+struct chunk {
+  size_t len; /* 0 marks the end of the input */
+  char data[CHUNK_SIZE];
+};
+
+struct ring {
+  /* Each index is written by one side only, keep them on their own lines */
+  _Alignas(64) atomic_size_t head; /* next slot to pop */
+  _Alignas(64) atomic_size_t tail; /* next slot to push */
+  struct chunk *slot[RING_SIZE];
+};
+
+struct pipeline {
+  int fd;
+  int error; /* errno of a failed read, valid after the last chunk */
+  struct ring full; /* reader to parser */
+  struct ring free; /* parser to reader */
+};
+
+struct stats {
+  size_t bytes, docs, tokens;
+};
+
+static struct chunk end_of_input;
+
+static int ring_push(struct ring *r, struct chunk *c) {
+  size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+  if (tail - atomic_load_explicit(&r->head, memory_order_acquire) ==
+      RING_SIZE) {
+    return 0;
+  }
+  r->slot[tail % RING_SIZE] = c;
+  atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+  return 1;
+}
+
+static struct chunk *ring_pop(struct ring *r) {
+  size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+  struct chunk *c;
+  if (atomic_load_explicit(&r->tail, memory_order_acquire) == head) {
+    return NULL;
+  }
+  c = r->slot[head % RING_SIZE];
+  atomic_store_explicit(&r->head, head + 1, memory_order_release);
+  return c;
+}
+
+static void *reader(void *arg) {
+  struct pipeline *pl = arg;
+  int done = 0;
+
+  while (!done) {
+    struct chunk *c = ring_pop(&pl->free);
+    if (c == NULL && (c = malloc(sizeof(*c))) == NULL) {
+      pl->error = ENOMEM;
+      break;
+    }
+    /* Fill whole chunks, pipes return at most a page or so per read */
+    for (c->len = 0; c->len < CHUNK_SIZE;) {
+      ssize_t n = read(pl->fd, c->data + c->len, CHUNK_SIZE - c->len);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        pl->error = n < 0 ? errno : 0;
+        done = 1;
+        break;
+      }
+      c->len += n;
+    }
+    if (c->len == 0) {
+      free(c);
+      break;
+    }
+    while (!ring_push(&pl->full, c)) {
+      sched_yield();
+    }
+  }
+  while (!ring_push(&pl->full, &end_of_input)) {
+    sched_yield();
+  }
+  return NULL;
+}
+
+static void recycle(struct pipeline *pl, struct chunk *c) {
+  if (!ring_push(&pl->free, c)) {
+    free(c);
+  }
+}
+
+/* Doubles an array of *cap elements, leaving it alone on failure */
+static void *grow(void *p, size_t *cap, size_t size) {
+  void *q = realloc(p, *cap * 2 * size);
+  if (q != NULL) {
+    *cap *= 2;
+  }
+  return q;
+}
+
+static int grow_tokens(jsmntok_t **tok, size_t *cap) {
+  jsmntok_t *t = grow(*tok, cap, sizeof(**tok));
+  if (t == NULL) {
+    return 0;
+  }
+  *tok = t;
+  return 1;
+}
+
+static int grow_scratch(char **scratch, size_t *cap) {
+  char *s = grow(*scratch, cap, 1);
+  if (s == NULL) {
+    return 0;
+  }
+  *scratch = s;
+  return 1;
+}
+
+static int grow_segments(jsmn_iovec **iov, struct chunk ***owner,
+                         size_t *cap) {
+  size_t n = *cap;
+  jsmn_iovec *v = grow(*iov, &n, sizeof(**iov));
+  struct chunk **o;
+  if (v == NULL) {
+    return 0;
+  }
+  *iov = v;
+  n = *cap;
+  o = grow(*owner, &n, sizeof(**owner));
+  if (o == NULL) {
+    return 0;
+  }
+  *owner = o;
+  *cap = n;
+  return 1;
+}
+
+static int run_pipeline(int fd, struct stats *st) {
+  static struct pipeline pl;
+  pthread_t thread;
+  jsmn_parser p;
+  size_t nseg = 0, segcap = 16, tokcap = 4096, scratchcap = 1 << 16;
+  jsmn_iovec *iov = malloc(segcap * sizeof(*iov));
+  struct chunk **owner = malloc(segcap * sizeof(*owner));
+  jsmntok_t *tok = malloc(tokcap * sizeof(*tok));
+  char *scratch = malloc(scratchcap);
+  struct chunk *c;
+  int r = JSMN_SUCCESS;
+
+  if (iov == NULL || owner == NULL || tok == NULL || scratch == NULL) {
+    r = JSMN_ERROR_NOMEM;
+    goto out;
+  }
+  pl.fd = fd;
+  if (pthread_create(&thread, NULL, reader, &pl) != 0) {
+    r = JSMN_ERROR_NOMEM;
+    goto out;
+  }
+  jsmn_init(&p);
+  p.flags = JSMN_STREAM;
+
+  for (;;) {
+    if ((c = ring_pop(&pl.full)) == NULL) {
+      sched_yield();
+      continue;
+    }
+    if (c->len == 0) {
+      break;
+    }
+    st->bytes += c->len;
+    if (nseg == segcap && !grow_segments(&iov, &owner, &segcap)) {
+      r = JSMN_ERROR_NOMEM;
+      break;
+    }
+    iov[nseg].base = c->data;
+    iov[nseg].len = c->len;
+    owner[nseg++] = c;
+
+    for (;;) {
+      size_t skip;
+      r = jsmn_parse_iov(&p, iov, nseg, tok, tokcap, scratch, scratchcap);
+      if (r == JSMN_ERROR_NOMEM) {
+        /* Out of tokens, or a token cut by a chunk end is too long */
+        if (p.toknext == tokcap ? grow_tokens(&tok, &tokcap)
+                                : grow_scratch(&scratch, &scratchcap)) {
+          continue;
+        }
+        break;
+      }
+      if (r != JSMN_SUCCESS || p.depth != 0 || p.toknext == 0) {
+        break;
+      }
+      /* A complete document: drop it with the chunks it used up */
+      st->docs++;
+      st->tokens += p.toknext;
+      skip = p.pos;
+      (void)jsmn_discard(&p, tok, p.toknext, skip);
+      while (nseg > 0 && skip >= iov[0].len) {
+        skip -= iov[0].len;
+        recycle(&pl, owner[0]);
+        nseg--;
+        memmove(iov, iov + 1, nseg * sizeof(*iov));
+        memmove(owner, owner + 1, nseg * sizeof(*owner));
+      }
+      if (nseg > 0) {
+        iov[0].base = (const char *)iov[0].base + skip;
+        iov[0].len -= skip;
+      }
+    }
+    if (r < 0 && r != JSMN_ERROR_UNEXPECTED_EOF &&
+        r != JSMN_ERROR_UNCLOSED_STRING && r != JSMN_ERROR_UNCLOSED_OBJECT &&
+        r != JSMN_ERROR_UNCLOSED_ARRAY) {
+      break;
+    }
+  }
+
+  /* Drain the reader so that it can finish */
+  while (c != &end_of_input) {
+    if ((c = ring_pop(&pl.full)) == NULL) {
+      sched_yield();
+    } else if (c != &end_of_input) {
+      free(c);
+    }
+  }
+  pthread_join(thread, NULL);
+  while ((c = ring_pop(&pl.free)) != NULL) {
+    free(c);
+  }
+  if (r == JSMN_SUCCESS && p.toknext > 0) {
+    r = JSMN_ERROR_UNEXPECTED_EOF;
+  }
+  if (pl.error != 0) {
+    fprintf(stderr, "read(): errno=%d\n", pl.error);
+    r = JSMN_ERROR_INVAL;
+  }
+out:
+  while (nseg > 0) {
+    free(owner[--nseg]);
+  }
+  free(iov);
+  free(owner);
+  free(tok);
+  free(scratch);
+  return r;
+}
+
+/* The read loop of jsondump for pipes, then the same parse */
+static int run_sequential(int fd, struct stats *st) {
+  size_t len = 0, cap = 1 << 16, tokcap = 4096, off = 0;
+  char *js = malloc(cap);
+  jsmntok_t *tok = malloc(tokcap * sizeof(*tok));
+  jsmn_parser p;
+  int r = JSMN_SUCCESS;
+
+  if (js == NULL || tok == NULL) {
+    r = JSMN_ERROR_NOMEM;
+    goto out;
+  }
+  for (;;) {
+    ssize_t n;
+    if (len == cap && !grow_scratch(&js, &cap)) {
+      r = JSMN_ERROR_NOMEM;
+      goto out;
+    }
+    n = read(fd, js + len, cap - len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      fprintf(stderr, "read(): errno=%d\n", errno);
+      r = JSMN_ERROR_INVAL;
+      goto out;
+    }
+    if (n == 0) {
+      break;
+    }
+    len += n;
+  }
+  st->bytes = len;
+
+  jsmn_init(&p);
+  p.flags = JSMN_STREAM;
+  for (;;) {
+    r = jsmn_parse(&p, js + off, len - off, tok, tokcap);
+    if (r == JSMN_ERROR_NOMEM && grow_tokens(&tok, &tokcap)) {
+      continue;
+    }
+    if (r != JSMN_SUCCESS || p.depth != 0 || p.toknext == 0) {
+      break;
+    }
+    st->docs++;
+    st->tokens += p.toknext;
+    off += p.pos;
+    (void)jsmn_discard(&p, tok, p.toknext, p.pos);
+  }
+  if (r == JSMN_SUCCESS && p.toknext > 0) {
+    r = JSMN_ERROR_UNEXPECTED_EOF;
+  }
+out:
+  free(js);
+  free(tok);
+  return r;
+}
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+  int r, fd = STDIN_FILENO;
+  int sequential = 0, report = 0;
+  struct stats st = {0, 0, 0};
+  double t0, t1;
+
+  while ((r = getopt(argc, argv, "st")) != -1) {
+    switch (r) {
+    case 's':
+      sequential = 1;
+      break;
+    case 't':
+      report = 1;
+      break;
+    default:
+      fprintf(stderr, "usage: %s [-s] [-t] [file]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (optind < argc) {
+    fd = open(argv[optind], O_RDONLY);
+    if (fd < 0) {
+      printf("Error: failed to open file %s\n", argv[optind]);
+      return -1;
+    }
+  }
+
+  t0 = now();
+  r = sequential ? run_sequential(fd, &st) : run_pipeline(fd, &st);
+  t1 = now();
+  if (fd != STDIN_FILENO) {
+    close(fd);
+  }
+
+  if (r != JSMN_SUCCESS) {
+    fprintf(stderr, "jsonpipe: %d after %zu documents\n", r, st.docs);
+    return EXIT_FAILURE;
+  }
+  printf("%zu documents, %zu tokens\n", st.docs, st.tokens);
+  if (report) {
+    fprintf(stderr, "%s: %zu bytes in %.3f s (%.1f MB/s)\n",
+            sequential ? "sequential" : "pipelined", st.bytes, t1 - t0,
+            st.bytes / (t1 - t0 > 0 ? t1 - t0 : 1e-9) / 1e6);
+  }
+  return EXIT_SUCCESS;
+}
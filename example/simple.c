@@ -13,7 +13,7 @@ static const char *JSON_STRING =
     "\"groups\": [\"users\", \"wheel\", \"audio\", \"video\"]}";
 
 static int jsoneq(const char *json, jsmntok_t *tok, const char *s) {
-  if (tok->type == JSMN_STRING && (int)strlen(s) == tok->end - tok->start &&
+  if (tok->type == JSMN_STRING && strlen(s) == tok->end - tok->start &&
       strncmp(json + tok->start, s, tok->end - tok->start) == 0) {
     return 0;
   }
@@ -21,7 +21,7 @@ static int jsoneq(const char *json, jsmntok_t *tok, const char *s) {
 }
 
 int main() {
-  int i;
+  int i, n;
   int r;
   jsmn_parser p;
   jsmntok_t t[128]; /* We expect no more than 128 tokens */
@@ -33,29 +33,31 @@ int main() {
     printf("Failed to parse JSON: %d\n", r);
     return 1;
   }
+  n = p.toknext;
 
   /* Assume the top-level element is an object */
-  if (r < 1 || t[0].type != JSMN_OBJECT) {
+  if (n < 1 || t[0].type != JSMN_OBJECT) {
     printf("Object expected\n");
     return 1;
   }
 
   /* Loop over all keys of the root object */
-  for (i = 1; i < r; i++) {
+  for (i = 1; i < n; i++) {
     if (jsoneq(JSON_STRING, &t[i], "user") == 0) {
       /* We may use strndup() to fetch string value */
-      printf("- User: %.*s\n", t[i + 1].end - t[i + 1].start,
+      printf("- User: %.*s\n", (int)(t[i + 1].end - t[i + 1].start),
              JSON_STRING + t[i + 1].start);
       i++;
     } else if (jsoneq(JSON_STRING, &t[i], "admin") == 0) {
       /* We may additionally check if the value is either "true" or "false" */
-      printf("- Admin: %.*s\n", t[i + 1].end - t[i + 1].start,
+      printf("- Admin: %.*s\n", (int)(t[i + 1].end - t[i + 1].start),
              JSON_STRING + t[i + 1].start);
       i++;
     } else if (jsoneq(JSON_STRING, &t[i], "uid") == 0) {
-      /* We may want to do strtol() here to get numeric value */
-      printf("- UID: %.*s\n", t[i + 1].end - t[i + 1].start,
-             JSON_STRING + t[i + 1].start);
+      int64_t uid;
+      if (jsmn_get_i64(JSON_STRING, &t[i + 1], &uid) == JSMN_SUCCESS) {
+        printf("- UID: %lld\n", (long long)uid);
+      }
       i++;
     } else if (jsoneq(JSON_STRING, &t[i], "groups") == 0) {
       int j;
@@ -65,11 +67,12 @@ int main() {
       }
       for (j = 0; j < t[i + 1].size; j++) {
         jsmntok_t *g = &t[i + j + 2];
-        printf("  * %.*s\n", g->end - g->start, JSON_STRING + g->start);
+        printf("  * %.*s\n", (int)(g->end - g->start),
+               JSON_STRING + g->start);
       }
       i += t[i + 1].size + 1;
     } else {
-      printf("Unexpected key: %.*s\n", t[i].end - t[i].start,
+      printf("Unexpected key: %.*s\n", (int)(t[i].end - t[i].start),
              JSON_STRING + t[i].start);
     }
   }
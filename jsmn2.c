@@ -31,11 +31,18 @@ static inline void jsmn_init_token(jsmntok_t *tok)
   tok->unclosed = false;
   tok->is_key = false;
   tok->associated = false;
+  tok->has_escapes = false;
+  tok->opaque = false;
+  tok->split = false;
   tok->start = -1;
+  tok->end = -1;
   tok->size = 0;
 #ifdef JSMN_PARENT_LINKS
   tok->parent = -1;
 #endif
+#ifdef JSMN_SYMTAB
+  tok->sym = JSMN_SYM_UNKNOWN;
+#endif
 }
 
 /**
@@ -61,9 +68,28 @@ static inline void jsmn_fill_token(jsmntok_t *token, const jsmntype_t type,
 {
   token->type = type;
   token->start = start;
+  token->end = end;
   token->size = end - start;
 }
 
+/**
+ * Open objects and arrays form a chain from the innermost one, in
+ * parser->tokopen, outwards. A token keeps the index of the next one in
+ * its end while it is unclosed, so closing brackets and commas find their
+ * container without scanning back over the tokens.
+ */
+static inline void jsmn_open_push(jsmn_parser *parser, jsmntok_t *tokens,
+                                  const int i)
+{
+  tokens[i].end = (size_t)parser->tokopen;
+  parser->tokopen = i;
+}
+
+static inline void jsmn_open_pop(jsmn_parser *parser, jsmntok_t *token)
+{
+  parser->tokopen = token->end == (size_t)-1 ? -1 : (int)token->end;
+}
+
 static inline bool ishexdigit(unsigned c)
 {
   unsigned short v1 = c - '0';
@@ -71,12 +97,246 @@ static inline bool ishexdigit(unsigned c)
   return (v1 <= 9) || (v2 <= 5);
 }
 
+static inline bool jsmn_isdigit(const char c)
+{
+  return (unsigned char)(c - '0') <= 9;
+}
+
+static inline bool jsmn_isspace(const char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' ||
+         c == '\v';
+}
+
+/**
+ * Loads 8 bytes in little-endian order regardless of the host byte order.
+ */
+static inline uint64_t jsmn_read64le(const char *p)
+{
+  const unsigned char *s = (const unsigned char *)p;
+  return (uint64_t)s[0] | (uint64_t)s[1] << 8 | (uint64_t)s[2] << 16 |
+         (uint64_t)s[3] << 24 | (uint64_t)s[4] << 32 | (uint64_t)s[5] << 40 |
+         (uint64_t)s[6] << 48 | (uint64_t)s[7] << 56;
+}
+
+/*
+ * Word-at-a-time (SWAR) byte tests on 8 bytes loaded with jsmn_read64le().
+ */
+#define JSMN_ONES 0x0101010101010101ULL
+#define JSMN_HIGHS 0x8080808080808080ULL
+
+/* Nonzero if any byte of v equals zero */
+#define JSMN_HASZERO(v) (((v)-JSMN_ONES) & ~(v)&JSMN_HIGHS)
+/* Nonzero if any byte of v equals c */
+#define JSMN_HASBYTE(v, c) JSMN_HASZERO((v) ^ (JSMN_ONES * (unsigned char)(c)))
+/* Nonzero if any byte of v is less than n, for n <= 128 */
+#define JSMN_HASLESS(v, n) (((v)-JSMN_ONES * (n)) & ~(v)&JSMN_HIGHS)
+
+/*
+ * String escapes.
+ */
+
+static inline unsigned jsmn_hexval(const char c)
+{
+  return jsmn_isdigit(c) ? (unsigned)(c - '0')
+                         : (unsigned)((c | 0x20) - 'a' + 10);
+}
+
+/**
+ * Reads the 4 hex digits of a \uXXXX escape, p points at the 'u'.
+ */
+static inline bool jsmn_read_ucs2(const char *p, const char *q, unsigned *cp)
+{
+  int i;
+
+  if (q - p < 5)
+    return false;
+  *cp = 0;
+  for (i = 1; i <= 4; i++) {
+    if (!ishexdigit(p[i]))
+      return false;
+    *cp = (*cp << 4) | jsmn_hexval(p[i]);
+  }
+  return true;
+}
+
+static inline size_t jsmn_utf8_encode(unsigned cp, char *buf)
+{
+  if (cp < 0x80) {
+    buf[0] = (char)cp;
+    return 1;
+  }
+  if (cp < 0x800) {
+    buf[0] = (char)(0xC0 | (cp >> 6));
+    buf[1] = (char)(0x80 | (cp & 0x3F));
+    return 2;
+  }
+  if (cp < 0x10000) {
+    buf[0] = (char)(0xE0 | (cp >> 12));
+    buf[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    buf[2] = (char)(0x80 | (cp & 0x3F));
+    return 3;
+  }
+  buf[0] = (char)(0xF0 | (cp >> 18));
+  buf[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+  buf[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+  buf[3] = (char)(0x80 | (cp & 0x3F));
+  return 4;
+}
+
+/**
+ * Validates the multi-byte UTF-8 sequence at p. Returns its length, 0 if it
+ * is malformed (overlong, surrogate or beyond U+10FFFF) or -1 if it is cut
+ * off by the end of the input.
+ */
+static inline int jsmn_utf8_sequence(const char *p, const char *q)
+{
+  const unsigned char *s = (const unsigned char *)p;
+  unsigned char lo = 0x80, hi = 0xBF;
+  int n, i;
+
+  if (s[0] >= 0xC2 && s[0] <= 0xDF) {
+    n = 2;
+  } else if (s[0] >= 0xE0 && s[0] <= 0xEF) {
+    n = 3;
+    if (s[0] == 0xE0)
+      lo = 0xA0;
+    else if (s[0] == 0xED)
+      hi = 0x9F;
+  } else if (s[0] >= 0xF0 && s[0] <= 0xF4) {
+    n = 4;
+    if (s[0] == 0xF0)
+      lo = 0x90;
+    else if (s[0] == 0xF4)
+      hi = 0x8F;
+  } else {
+    return 0;
+  }
+  for (i = 1; i < n; i++, lo = 0x80, hi = 0xBF) {
+    if (p + i >= q)
+      return -1;
+    if (s[i] < lo || s[i] > hi)
+      return 0;
+  }
+  return n;
+}
+
+/**
+ * Decodes one escape sequence at p (pointing at the backslash) into buf.
+ * Surrogate pairs are joined into a single 4-byte UTF-8 sequence. Returns
+ * the number of input bytes consumed, or 0 if the escape is invalid.
+ */
+static size_t jsmn_decode_escape(const char *p, const char *q, char *buf,
+                                 size_t *n)
+{
+  unsigned cp, lo;
+
+  if (q - p < 2)
+    return 0;
+  *n = 1;
+  switch (p[1]) {
+  case '\"':
+  case '/':
+  case '\\':
+    buf[0] = p[1];
+    return 2;
+  case 'b':
+    buf[0] = '\b';
+    return 2;
+  case 'f':
+    buf[0] = '\f';
+    return 2;
+  case 'n':
+    buf[0] = '\n';
+    return 2;
+  case 'r':
+    buf[0] = '\r';
+    return 2;
+  case 't':
+    buf[0] = '\t';
+    return 2;
+  case 'u':
+    if (!jsmn_read_ucs2(p + 1, q, &cp))
+      return 0;
+    if (cp >= 0xD800 && cp <= 0xDBFF) {
+      /* High surrogate, must be followed by a low one */
+      if (q - p < 12 || p[6] != '\\' || p[7] != 'u' ||
+          !jsmn_read_ucs2(p + 7, q, &lo) || lo < 0xDC00 || lo > 0xDFFF)
+        return 0;
+      *n = jsmn_utf8_encode(0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00),
+                            buf);
+      return 12;
+    }
+    if (cp >= 0xDC00 && cp <= 0xDFFF)
+      return 0;
+    *n = jsmn_utf8_encode(cp, buf);
+    return 6;
+  default:
+    return 0;
+  }
+}
+
+/**
+ * Decodes the escaped string src[0..n) into dst. dst may be NULL to only
+ * compute the length, and may alias src since the output never outgrows
+ * the input. Escape-free runs are located 8 bytes at a time and copied in
+ * bulk.
+ */
+static enum jsmnerr jsmn_unescape_span(const char *src, const size_t n,
+                                       char *dst, const size_t cap,
+                                       size_t *outlen)
+{
+  const char *p = src;
+  const char *q = src + n;
+  enum jsmnerr res = JSMN_SUCCESS;
+  size_t o = 0;
+
+  while (p < q) {
+    const char *run = p;
+    char buf[4];
+    size_t len, used;
+
+    for (; q - p >= 8; p += 8) {
+      const uint64_t v = jsmn_read64le(p);
+      if (JSMN_HASBYTE(v, '\\'))
+        break;
+    }
+    while (p < q && *p != '\\')
+      p++;
+
+    len = p - run;
+    if (dst != NULL && o + len > cap) {
+      dst = NULL;
+      res = JSMN_ERROR_NOMEM;
+    }
+    if (dst != NULL)
+      (void)memmove(dst + o, run, len);
+    o += len;
+    if (p == q)
+      break;
+
+    if ((used = jsmn_decode_escape(p, q, buf, &len)) == 0)
+      return JSMN_ERROR_INVAL;
+    p += used;
+    if (dst != NULL && o + len > cap) {
+      dst = NULL;
+      res = JSMN_ERROR_NOMEM;
+    }
+    if (dst != NULL)
+      (void)memcpy(dst + o, buf, len);
+    o += len;
+  }
+  *outlen = o;
+  return res;
+}
+
 /**
  * Fills next available token with JSON primitive.
  */
 static inline enum jsmnerr jsmn_parse_primitive(jsmn_parser *parser, const char *js,
                                 const size_t len, jsmntok_t *tokens,
-                                const size_t num_tokens)
+                                const size_t num_tokens, char *insitu,
+                                const size_t base)
 {
   jsmntok_t *token;
   int start;
@@ -109,24 +369,353 @@ static inline enum jsmnerr jsmn_parse_primitive(jsmn_parser *parser, const char
 found:
   parser->pos = p - js;
   parser->col += parser->pos - start;
+  /* The delimiter is still needed, terminate once it is consumed */
+  if (insitu != NULL)
+    parser->__insitu_nul = parser->pos;
   token = jsmn_alloc_token(parser, tokens, num_tokens);
   if (token == NULL) {
     token = &parser->tokbuf;
     res = JSMN_ERROR_NOMEM;
   }
-  jsmn_fill_token(token, JSMN_PRIMITIVE, start, parser->pos);
+  jsmn_fill_token(token, JSMN_PRIMITIVE, base + start, base + parser->pos);
 #ifdef JSMN_PARENT_LINKS
   token->parent = parser->toksuper;
 #endif
   return res;
 }
 
+/*
+ * Key hashing and symbol tables.
+ */
+
+#define JSMN_FNV_OFFSET 2166136261u
+#define JSMN_FNV_PRIME 16777619u
+
+/**
+ * FNV-1a over n bytes, continuing from h. Byte-at-a-time so that keys can
+ * be hashed piecewise while their escapes are decoded.
+ */
+static inline uint32_t jsmn_hash(uint32_t h, const char *p, const size_t n)
+{
+  size_t i;
+  for (i = 0; i < n; i++)
+    h = (h ^ (unsigned char)p[i]) * JSMN_FNV_PRIME;
+  return h;
+}
+
+/**
+ * Hashes the decoded value of a key token. Invalid escapes are hashed
+ * raw; they can never compare equal to anything anyway.
+ */
+static uint32_t jsmn_key_hash(const char *js, const jsmntok_t *tok)
+{
+  const char *p = js + tok->start;
+  const char *q = p + tok->size;
+  uint32_t h = JSMN_FNV_OFFSET;
+
+  if (!tok->has_escapes)
+    return jsmn_hash(h, p, tok->size);
+  while (p < q) {
+    char buf[4];
+    size_t used, n;
+    if (*p != '\\' || (used = jsmn_decode_escape(p, q, buf, &n)) == 0) {
+      h = jsmn_hash(h, p++, 1);
+      continue;
+    }
+    h = jsmn_hash(h, buf, n);
+    p += used;
+  }
+  return h;
+}
+
+/**
+ * Compares the decoded value of a string token with s[0..n), or with its
+ * first n bytes if prefix is set.
+ */
+static bool jsmn_string_match(const char *js, const jsmntok_t *tok,
+                              const char *s, const size_t n, const bool prefix)
+{
+  const char *p = js + tok->start;
+  const char *q = p + tok->size;
+  size_t o = 0;
+
+  /* Decoding never makes a string longer */
+  if ((size_t)tok->size < n)
+    return false;
+  if (!tok->has_escapes)
+    return ((size_t)tok->size == n || prefix) && memcmp(p, s, n) == 0;
+  while (p < q) {
+    const char *run = p;
+    char buf[4];
+    size_t used, k;
+
+    while (p < q && *p != '\\')
+      p++;
+    k = p - run;
+    if (prefix && k > n - o)
+      k = n - o;
+    if (k > n - o || memcmp(run, s + o, k) != 0)
+      return false;
+    o += k;
+    if (p == q || (prefix && o == n))
+      break;
+    if ((used = jsmn_decode_escape(p, q, buf, &k)) == 0)
+      return false;
+    if (prefix && k > n - o)
+      k = n - o;
+    if (k > n - o || memcmp(buf, s + o, k) != 0)
+      return false;
+    o += k;
+    p += used;
+  }
+  return o == n;
+}
+
+/**
+ * Compares the decoded value of a key token with key[0..keylen).
+ */
+static inline bool jsmn_key_equal(const char *js, const jsmntok_t *tok,
+                                  const char *key, const size_t keylen)
+{
+  return jsmn_string_match(js, tok, key, keylen, false);
+}
+
+#ifdef JSMN_SYMTAB
+/**
+ * Finds the symbol for a key token (or a plain name wrapped in one). If it
+ * is unknown and add is set, its decoded name is copied into the name
+ * buffer and it gets the next id, as long as there is room.
+ */
+static int jsmn_symtab_lookup(jsmn_symtab *symtab, const char *js,
+                              const jsmntok_t *tok, const bool add)
+{
+  const unsigned int mask = symtab->nslots - 1;
+  const uint32_t h = jsmn_key_hash(js, tok);
+  unsigned int s;
+  size_t len = tok->size;
+
+  for (s = h & mask; symtab->slots[s].id != JSMN_SYM_UNKNOWN;
+       s = (s + 1) & mask) {
+    const jsmn_sym *sym = &symtab->slots[s];
+    if (sym->hash == h && jsmn_key_equal(js, tok, symtab->names + sym->off,
+                                         sym->len))
+      return sym->id;
+  }
+
+  /* Keep a quarter of the slots free so that probe runs stay short */
+  if (!add || 4 * (symtab->count + 1) > 3 * symtab->nslots ||
+      len > symtab->namecap - symtab->namelen)
+    return JSMN_SYM_UNKNOWN;
+  if (!tok->has_escapes)
+    (void)memcpy(symtab->names + symtab->namelen, js + tok->start, len);
+  else if (jsmn_unescape_span(js + tok->start, tok->size,
+                              symtab->names + symtab->namelen, len,
+                              &len) != JSMN_SUCCESS)
+    return JSMN_SYM_UNKNOWN;
+
+  symtab->slots[s].hash = h;
+  symtab->slots[s].id = symtab->count++;
+  symtab->slots[s].off = symtab->namelen;
+  symtab->slots[s].len = len;
+  symtab->namelen += len;
+  return symtab->slots[s].id;
+}
+
+/**
+ * Wraps a plain name into a token so it can go through the key helpers.
+ */
+static inline jsmntok_t jsmn_name_token(const size_t len)
+{
+  jsmntok_t tok;
+  jsmn_init_token(&tok);
+  tok.type = JSMN_STRING;
+  tok.start = 0;
+  tok.size = len;
+  return tok;
+}
+#endif
+
+/*
+ * Shape cache.
+ */
+
+static inline uint32_t jsmn_path_mix(uint32_t h, const uint32_t x)
+{
+  h = (h ^ x) * JSMN_FNV_PRIME;
+  return h ^ (h >> 15);
+}
+
+/**
+ * Returns the cursor of the innermost open object if it has a live shape.
+ */
+static inline int jsmn_shape_cursor(const jsmn_parser *parser)
+{
+  const jsmn_shape_cache *cache = parser->shapes;
+  const unsigned int d = parser->depth - 1;
+
+  if (parser->depth == 0 || d >= JSMN_SHAPE_DEPTH ||
+      cache->stack[d].shape < 0 ||
+      cache->shapes[cache->stack[d].shape].path != cache->stack[d].path)
+    return -1;
+  return d;
+}
+
+/**
+ * Pushes a container that was just opened. Objects take over the shape
+ * slot of their path signature.
+ */
+static void jsmn_shape_open(jsmn_parser *parser, const bool object)
+{
+  jsmn_shape_cache *cache = parser->shapes;
+  const unsigned int d = parser->depth - 1;
+  uint32_t path = JSMN_FNV_OFFSET;
+  jsmn_shape *shape;
+
+  if (d >= JSMN_SHAPE_DEPTH)
+    return;
+  if (d > 0)
+    path = jsmn_path_mix(cache->stack[d - 1].path,
+                         cache->stack[d - 1].object ? cache->stack[d - 1].key
+                                                    : '[');
+  cache->stack[d].path = path;
+  cache->stack[d].object = object;
+  cache->stack[d].shape = -1;
+  cache->stack[d].k = 0;
+  cache->stack[d].off = 0;
+  if (!object)
+    return;
+  cache->stack[d].shape = path & (cache->nshapes - 1);
+  shape = &cache->shapes[cache->stack[d].shape];
+  if (shape->path != path) {
+    shape->path = path;
+    shape->nkeys = 0;
+    shape->nbytes = 0;
+  }
+}
+
+/**
+ * Pops a container. An object with fewer keys than its shape cuts it short,
+ * so the shape is always the key sequence of the last object.
+ */
+static void jsmn_shape_close(jsmn_parser *parser)
+{
+  jsmn_shape_cache *cache = parser->shapes;
+  const int d = jsmn_shape_cursor(parser);
+  jsmn_shape *shape;
+
+  if (d < 0)
+    return;
+  shape = &cache->shapes[cache->stack[d].shape];
+  if (cache->stack[d].k < shape->nkeys) {
+    shape->nkeys = cache->stack[d].k;
+    shape->nbytes = cache->stack[d].off;
+  }
+}
+
+/**
+ * Returns the predicted key of the innermost object if the input at the
+ * parser position (the opening quote) matches it byte for byte.
+ */
+static inline int jsmn_shape_predict(const jsmn_parser *parser,
+                                     const char *js, const size_t len)
+{
+  const jsmn_shape_cache *cache = parser->shapes;
+  const int d = jsmn_shape_cursor(parser);
+  const jsmn_shape *shape;
+  unsigned int k, n;
+
+  if (d < 0)
+    return -1;
+  k = cache->stack[d].k;
+  shape = &cache->shapes[cache->stack[d].shape];
+  if (k >= shape->nkeys)
+    return -1;
+  n = shape->keys[k].len;
+  if (len - parser->pos < n ||
+      memcmp(js + parser->pos, shape->bytes + cache->stack[d].off, n) != 0)
+    return -1;
+  if ((parser->flags & JSMN_VALIDATE_UTF8) && !shape->keys[k].checked)
+    return -1;
+  return k;
+}
+
+/**
+ * Moves the cursor past a key token. A key that was not predicted replaces
+ * the rest of the shape.
+ */
+static void jsmn_shape_advance(jsmn_parser *parser, const char *js,
+                               const jsmntok_t *tok, const bool hit)
+{
+  jsmn_shape_cache *cache = parser->shapes;
+  const int d = jsmn_shape_cursor(parser);
+  const unsigned int n = tok->size + 2;
+  jsmn_shape *shape;
+  unsigned int k;
+
+  if (d < 0)
+    return;
+  shape = &cache->shapes[cache->stack[d].shape];
+  k = cache->stack[d].k;
+  if (hit) {
+    cache->hits++;
+  } else {
+    cache->misses++;
+    if (k < shape->nkeys) {
+      shape->nkeys = k;
+      shape->nbytes = cache->stack[d].off;
+    }
+    if (k == shape->nkeys && k < JSMN_SHAPE_KEYS &&
+        n <= JSMN_SHAPE_BYTES - shape->nbytes) {
+      (void)memcpy(shape->bytes + shape->nbytes, js + tok->start - 1, n);
+      shape->keys[k].hash = jsmn_hash(JSMN_FNV_OFFSET, js + tok->start,
+                                      tok->size);
+      shape->keys[k].len = n;
+      shape->keys[k].has_escapes = tok->has_escapes;
+      shape->keys[k].checked = (parser->flags & JSMN_VALIDATE_UTF8) != 0;
+#ifdef JSMN_SYMTAB
+      shape->keys[k].sym = tok->sym;
+#endif
+      shape->nkeys++;
+      shape->nbytes += n;
+    }
+  }
+  cache->stack[d].key = k < shape->nkeys
+                            ? shape->keys[k].hash
+                            : jsmn_hash(JSMN_FNV_OFFSET, js + tok->start,
+                                        tok->size);
+  cache->stack[d].k = k + 1;
+  cache->stack[d].off += n;
+}
+
+/**
+ * Decodes a string token in place and NUL-terminates it (in-situ mode).
+ * Only done once the token is kept, so that a string that is dropped or
+ * scanned again later is still intact. A lone surrogate escape has no
+ * UTF-8 encoding and is rejected.
+ */
+static enum jsmnerr jsmn_insitu_string(char *insitu, jsmntok_t *token)
+{
+  size_t n = token->size;
+
+  /* Decoding never grows the string, so it fits in place */
+  if (token->has_escapes &&
+      jsmn_unescape_span(insitu + token->start, n, insitu + token->start, n,
+                         &n) != JSMN_SUCCESS)
+    return JSMN_ERROR_INVALID_UTF8;
+  insitu[token->start + n] = '\0';
+  token->end = token->start + n;
+  token->size = n;
+  token->has_escapes = false;
+  return JSMN_SUCCESS;
+}
+
 /**
  * Fills next token with JSON string.
  */
 static inline enum jsmnerr jsmn_parse_string(jsmn_parser *parser, const char *js,
                              const size_t len, jsmntok_t *tokens,
-                             const size_t num_tokens)
+                             const size_t num_tokens, char *insitu,
+                             const size_t base)
 {
   jsmntok_t *token;
   int start = parser->pos;
@@ -134,29 +723,75 @@ static inline enum jsmnerr jsmn_parse_string(jsmn_parser *parser, const char *js
   const char *q = js + len;
   //unsigned int col = parser->col;
   enum jsmnerr res = JSMN_SUCCESS;
+  bool escaped = false;
+  const bool utf8 = (parser->flags & JSMN_VALIDATE_UTF8) != 0;
+  const uint64_t high = utf8 ? JSMN_HIGHS : 0;
+  unsigned cp, lo;
+  int n, predicted = -1;
+
+  /* A key predicted by the shape cache is taken as a whole: jump to its
+   * closing quote */
+  if (parser->shapes != NULL && insitu == NULL && parser->toksuper != -1 &&
+      tokens[parser->toksuper].type == JSMN_OBJECT &&
+      (predicted = jsmn_shape_predict(parser, js, len)) >= 0) {
+    const jsmn_shape_cache *cache = parser->shapes;
+    const jsmn_shape *shape =
+        &cache->shapes[cache->stack[parser->depth - 1].shape];
+    p = js + start + shape->keys[predicted].len - 1;
+    escaped = shape->keys[predicted].has_escapes;
+  }
 
   for (; p < q && *p != '\0';) {
+    /* Skip plain characters 8 at a time, validating ASCII on the way */
+    for (; q - p >= 8; p += 8) {
+      const uint64_t v = jsmn_read64le(p);
+      if (JSMN_HASBYTE(v, '\"') | JSMN_HASBYTE(v, '\\') | JSMN_HASZERO(v) |
+          (v & high))
+        break;
+    }
+    if (p == q || *p == '\0')
+      break;
+
     /* Quote: end of string */
     if (*p == '\"') {
+      const size_t n = p - js - start - 1;
       token = jsmn_alloc_token(parser, tokens, num_tokens);
       if (token == NULL) {
         token = &parser->tokbuf;
         res = JSMN_ERROR_NOMEM;
       }
       parser->pos = p - js;
-      jsmn_fill_token(token, JSMN_STRING, start + 1, parser->pos);
+      jsmn_fill_token(token, JSMN_STRING, start + 1, start + 1 + n);
+      token->has_escapes = escaped;
       parser->pos++;
       parser->col += (p - js - start + 1);
 #ifdef JSMN_PARENT_LINKS
       token->parent = parser->toksuper;
 #endif
-      if ((tokens + parser->toksuper)->type == JSMN_OBJECT)
+      if ((tokens + parser->toksuper)->type == JSMN_OBJECT) {
         token->is_key = true;
+#ifdef JSMN_SYMTAB
+        if (predicted >= 0)
+          token->sym = parser->shapes
+                           ->shapes[parser->shapes
+                                        ->stack[parser->depth - 1].shape]
+                           .keys[predicted].sym;
+        if (parser->symtab != NULL && token->sym == JSMN_SYM_UNKNOWN)
+          token->sym = jsmn_symtab_lookup(parser->symtab, js, token,
+                                          parser->symtab->add);
+#endif
+        if (parser->shapes != NULL && insitu == NULL)
+          jsmn_shape_advance(parser, js, token, predicted >= 0);
+      }
+      /* Looked up through js above, now made an offset into the input */
+      token->start += base;
+      token->end += base;
       return res;
     }
 
     /* Backslash: Quoted symbol expected */
     if (*p == '\\' && p + 1 < q) {
+      escaped = true;
       switch (*++p) {
       /* Allowed escaped symbols */
       case '\"':
@@ -171,17 +806,32 @@ static inline enum jsmnerr jsmn_parse_string(jsmn_parser *parser, const char *js
         break;
       /* Allows escaped symbol \uXXXX */
       case 'u':
-        p++;
-        /* FIXME: check for invalid codepoints!! */
-        for (int i = 0; i < 4 && *p != '\n'; p++, i++) {
-          if (!ishexdigit(*p))
-            return JSMN_ERROR_INVAL;
-        }
+        if (q - p < 5)
+          return JSMN_ERROR_UNCLOSED_STRING;
+        if (!jsmn_read_ucs2(p, q, &cp))
+          return JSMN_ERROR_INVAL;
+        p += 5;
+        if (!utf8 || cp < 0xD800 || cp > 0xDFFF)
+          break;
+        /* A high surrogate must be followed by a low one */
+        if (cp >= 0xDC00 || (p < q && p[0] != '\\') ||
+            (q - p > 1 && p[1] != 'u'))
+          return JSMN_ERROR_INVALID_UTF8;
+        if (q - p < 6)
+          return JSMN_ERROR_UNCLOSED_STRING;
+        if (p[0] != '\\' || p[1] != 'u' || !jsmn_read_ucs2(p + 1, q, &lo) ||
+            lo < 0xDC00 || lo > 0xDFFF)
+          return JSMN_ERROR_INVALID_UTF8;
+        p += 6;
         break;
       /* Unexpected symbol */
       default:
         return JSMN_ERROR_INVAL;
       }
+    } else if (utf8 && (unsigned char)*p >= 0x80) {
+      if ((n = jsmn_utf8_sequence(p, q)) <= 0)
+        return n ? JSMN_ERROR_UNCLOSED_STRING : JSMN_ERROR_INVALID_UTF8;
+      p += n;
     } else {
       p++;
     }
@@ -189,6 +839,10 @@ static inline enum jsmnerr jsmn_parse_string(jsmn_parser *parser, const char *js
   return JSMN_ERROR_UNCLOSED_STRING;
 }
 
+/**
+ * Returns -1 for a \r not followed by \n, and 1 with pos on the \r if the
+ * input ends right after it, since the \n may still arrive.
+ */
 static inline int jamn_skip_whitespaces(jsmn_parser *parser, const char *js, const size_t len)
 {
   const char *p = js + parser->pos;
@@ -197,6 +851,10 @@ static inline int jamn_skip_whitespaces(jsmn_parser *parser, const char *js, con
   do {
     switch (*p) {
       case '\r':
+        if (p + 1 == q) {
+          parser->pos = p - js;
+          return 1;
+        }
         if (*++p != '\n')
           return -1; // broken newline
         /* FALLTHROUGH */
@@ -220,47 +878,442 @@ out:
   return 0;
 }
 
+/*
+ * Projection.
+ */
+
 /**
- * Parse JSON string and fill tokens.
+ * Scans on through the string or container being skipped, from the parser
+ * position with the state kept in parser->__skip_*. Strings are skipped 8
+ * bytes at a time up to the next quote or backslash, and containers up to
+ * the next quote, bracket or newline. Only string termination, bracket
+ * balance and the type of the outer closing bracket are checked. The scan
+ * stops at stop, or at the end of the input, with the state saved: this
+ * returns JSMN_YIELD or the unclosed error of the value, and the next call
+ * picks it up there.
  */
-#define JSMN_PARSER_ADVANCE(p,n) do { (p)->pos+=(n); (p)->col+=(n); } while (0)
-JSMN_API enum jsmnerr jsmn_parse(jsmn_parser *parser, const char *js, const size_t len,
-                        jsmntok_t *tokens, const unsigned int num_tokens)
+static enum jsmnerr jsmn_skip_resume(jsmn_parser *parser, const char *js,
+                                     const size_t len, const size_t stop)
 {
-  enum jsmnerr r;
-  int i;
-  jsmntok_t *token;
+  const char *start = js + parser->pos;
+  const char *p = start;
+  const char *q = js + (stop < len ? stop : len);
+  const char *nl = NULL;
+  unsigned int lines = 0, depth = parser->__skip_depth;
+  bool str = parser->__skip_str;
+  enum jsmnerr r = JSMN_SUCCESS;
 
-  assert(tokens != NULL);
+  for (;;) {
+    if (str) {
+      for (;;) {
+        for (; q - p >= 8; p += 8) {
+          const uint64_t v = jsmn_read64le(p);
+          if (JSMN_HASBYTE(v, '\"') | JSMN_HASBYTE(v, '\\') | JSMN_HASZERO(v))
+            break;
+        }
+        if (p >= q || *p == '\0')
+          goto pause;
+        if (*p == '\"')
+          break;
+        if (*p != '\\') {
+          p++;
+        } else if (js + len - p >= 2) {
+          /* An escape may step past stop, but never stops halfway */
+          p += 2;
+        } else {
+          goto pause;
+        }
+      }
+      str = false;
+      p++;
+      if (depth == 0)
+        goto done;
+      continue;
+    }
+    for (; q - p >= 8; p += 8) {
+      const uint64_t v = jsmn_read64le(p);
+      /* Setting bit 5 folds '[' and ']' onto '{' and '}' */
+      const uint64_t w = v | (JSMN_ONES * 0x20);
+      if (JSMN_HASBYTE(v, '\"') | JSMN_HASBYTE(w, '{') |
+          JSMN_HASBYTE(w, '}') | JSMN_HASBYTE(v, '\n') | JSMN_HASZERO(v))
+        break;
+    }
+    if (p >= q || *p == '\0')
+      goto pause;
+    switch (*p) {
+    case '\"':
+      str = true;
+      break;
+    case '{':
+    case '[':
+      depth++;
+      break;
+    case '}':
+    case ']':
+      if (--depth == 0) {
+        if ((*p == '}') != (parser->__skip_open == '{'))
+          return JSMN_ERROR_UNEXPECTED_CHAR;
+        p++;
+        goto done;
+      }
+      break;
+    case '\n':
+      lines++;
+      nl = p;
+      break;
+    }
+    p++;
+  }
 
-  if (parser->tokbuf.type != JSMN_UNDEFINED) {
-    token = jsmn_alloc_token(parser, tokens, num_tokens);
-    if (token == NULL)
-      return JSMN_ERROR_NOMEM;
-    (void)memcpy(token, &parser->tokbuf, sizeof(*token));
-    parser->tokbuf.type = JSMN_UNDEFINED;
-    parser->tokbuf.unclosed = false;
-    parser->tokbuf.is_key = false;
-#ifdef JSMN_NO_TRAILING_COMMAS
-    parser->__last_is_comma = false;
-#endif
+pause:
+  parser->__skip_depth = depth;
+  parser->__skip_str = str;
+  if (p >= q && stop < len)
+    r = JSMN_YIELD;
+  else if (parser->__skip_open == '\"')
+    r = JSMN_ERROR_UNCLOSED_STRING;
+  else if (parser->__skip_open == '{')
+    r = JSMN_ERROR_UNCLOSED_OBJECT;
+  else
+    r = JSMN_ERROR_UNCLOSED_ARRAY;
+  goto out;
+done:
+  parser->__skip_open = 0;
+out:
+  parser->pos = p - js;
+  if (lines > 0) {
+    parser->line += lines;
+    parser->col = p - nl;
+  } else {
+    parser->col += p - start;
   }
+  return r;
+}
 
-  for (; parser->pos < len && js[parser->pos] != '\0';) {
-    char c;
-    jsmntype_t type;
-    unsigned int line = parser->line;
-    unsigned int col = parser->col;
-    unsigned int start = parser->pos;
+/**
+ * Skips the value at the parser position without emitting tokens. A
+ * primitive is skipped whole, or not at all with JSMN_ERROR_UNEXPECTED_EOF
+ * if the input runs out first. Strings and containers go on through
+ * jsmn_skip_resume(), which may leave them pending. No value at all is
+ * JSMN_ERROR_UNEXPECTED_CHAR.
+ */
+static enum jsmnerr jsmn_skip_value(jsmn_parser *parser, const char *js,
+                                    const size_t len, const size_t stop)
+{
+  const char *p = js + parser->pos;
 
-    c = js[parser->pos];
-    switch (c) {
-    case '{':
-    case '[':
+  switch (*p) {
+  case '\"':
+  case '{':
+  case '[':
+    parser->__skip_open = *p;
+    parser->__skip_str = (*p == '\"');
+    parser->__skip_depth = (*p != '\"');
+    parser->pos++;
+    parser->col++;
+    return jsmn_skip_resume(parser, js, len, stop);
+  case ',':
+  case ':':
+  case ']':
+  case '}':
+    return JSMN_ERROR_UNEXPECTED_CHAR;
+  }
+  for (; p < js + len && *p != '\0'; p++) {
+    if (*p == ',' || *p == ']' || *p == '}' || jsmn_isspace(*p)) {
+      parser->col += p - (js + parser->pos);
+      parser->pos = p - js;
+      return JSMN_SUCCESS;
+    }
+  }
+  return JSMN_ERROR_UNEXPECTED_EOF;
+}
+
+/**
+ * Follows the edge of a trie node for an object key, returns the child
+ * node or -1.
+ */
+static int jsmn_paths_key(const jsmn_paths *paths, const unsigned int node,
+                          const char *js, const jsmntok_t *key)
+{
+  const jsmn_path_edge *e = paths->edges + paths->nodes[node].first;
+  const uint32_t h = jsmn_key_hash(js, key);
+  unsigned int lo = 0, hi = paths->nodes[node].nkeys;
+
+  while (lo < hi) {
+    const unsigned int mid = lo + (hi - lo) / 2;
+    if (e[mid].hash < h)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  for (; lo < paths->nodes[node].nkeys && e[lo].hash == h; lo++) {
+    if (jsmn_key_equal(js, key, e[lo].name, e[lo].len))
+      return e[lo].child;
+  }
+  return -1;
+}
+
+/**
+ * Follows the edge of a trie node for an array element, returns the child
+ * node or -1.
+ */
+static int jsmn_paths_index(const jsmn_paths *paths, const unsigned int node,
+                            const unsigned int i)
+{
+  const jsmn_path_node *n = &paths->nodes[node];
+  const jsmn_path_edge *e = paths->edges + n->first + n->nkeys;
+  unsigned int lo = 0, hi = n->nidx;
+
+  while (lo < hi) {
+    const unsigned int mid = lo + (hi - lo) / 2;
+    if (e[mid].index < (int)i)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo < n->nidx && e[lo].index == (int)i)
+    return e[lo].child;
+  if (n->nidx > 0 && e[0].index == JSMN_PATH_ANY)
+    return e[0].child;
+  return -1;
+}
+
+/**
+ * Enters a container that was just opened. It is either part of the
+ * selected subtree or on the way to one.
+ */
+static void jsmn_project_open(jsmn_parser *parser)
+{
+  jsmn_projection *proj = parser->proj;
+  const unsigned int d = parser->depth - 1;
+  unsigned int node = 0;
+
+  if (proj->all != 0)
+    return;
+  if (d > 0)
+    node = proj->stack[d - 1].next;
+  if (proj->paths->nodes[node].terminal) {
+    proj->all = parser->depth;
+    return;
+  }
+  proj->stack[d].node = node;
+  proj->stack[d].index = 0;
+  proj->stack[d].at = 0;
+}
+
+/**
+ * Decides whether the value following a key is wanted. Returns 0 to keep
+ * the key, 1 if the key and its value are skipped, or an error. A skip
+ * left pending by jsmn_skip_value() counts as skipped.
+ */
+static int jsmn_project_key(jsmn_parser *parser, const char *js,
+                            const size_t len, const size_t stop,
+                            const jsmntok_t *key)
+{
+  enum jsmnerr r;
+  jsmn_projection *proj = parser->proj;
+  const unsigned int d = parser->depth - 1;
+  const int child = jsmn_paths_key(proj->paths, proj->stack[d].node, js, key);
+  const unsigned int pos = parser->pos;
+  const unsigned int line = parser->line;
+  const unsigned int col = parser->col;
+  int ws = 0;
+  char c;
+
+  if (child >= 0 && proj->paths->nodes[child].terminal) {
+    proj->stack[d].next = child;
+    return 0;
+  }
+
+  /* Find the value: the path can only continue through a container */
+  if (parser->pos < len && jsmn_isspace(js[parser->pos]) &&
+      (ws = jamn_skip_whitespaces(parser, js, len)) < 0)
+    return JSMN_ERROR_BROKEN_NEWLINE;
+  if (ws > 0 || parser->pos >= len || js[parser->pos] == '\0')
+    return JSMN_ERROR_UNEXPECTED_EOF;
+  if (js[parser->pos] != ':')
+    return JSMN_ERROR_UNEXPECTED_CHAR;
+  parser->pos++;
+  parser->col++;
+  if (parser->pos < len && jsmn_isspace(js[parser->pos]) &&
+      (ws = jamn_skip_whitespaces(parser, js, len)) < 0)
+    return JSMN_ERROR_BROKEN_NEWLINE;
+  if (ws > 0 || parser->pos >= len || js[parser->pos] == '\0')
+    return JSMN_ERROR_UNEXPECTED_EOF;
+
+  c = js[parser->pos];
+  if (child >= 0 && (c == '{' || c == '[')) {
+    /* Leave the colon to the parser */
+    parser->pos = pos;
+    parser->line = line;
+    parser->col = col;
+    proj->stack[d].next = child;
+    return 0;
+  }
+  r = jsmn_skip_value(parser, js, len, stop);
+  if (r == JSMN_ERROR_UNEXPECTED_EOF || r == JSMN_ERROR_UNEXPECTED_CHAR)
+    return r;
+  return 1;
+}
+
+/**
+ * Decides whether the array element starting with c is wanted. Returns 0
+ * to keep it, 1 if it is skipped, or an error. A skip left pending by
+ * jsmn_skip_value() counts as skipped.
+ */
+static int jsmn_project_element(jsmn_parser *parser, const char *js,
+                                const size_t len, const size_t stop,
+                                const char c)
+{
+  jsmn_projection *proj = parser->proj;
+  const unsigned int d = parser->depth - 1;
+  unsigned int i = proj->stack[d].index;
+  enum jsmnerr r;
+  int child;
+
+  /* Kept before, but its token could not be completed */
+  if (proj->stack[d].at == parser->pos)
+    i--;
+  child = jsmn_paths_index(proj->paths, proj->stack[d].node, i);
+  if (child >= 0 &&
+      (proj->paths->nodes[child].terminal || c == '{' || c == '[')) {
+    proj->stack[d].next = child;
+    proj->stack[d].index = i + 1;
+    proj->stack[d].at = parser->pos;
+    return 0;
+  }
+  r = jsmn_skip_value(parser, js, len, stop);
+  if (r == JSMN_ERROR_UNEXPECTED_EOF || r == JSMN_ERROR_UNEXPECTED_CHAR)
+    return r;
+  proj->stack[d].index = i + 1;
+  return 1;
+}
+
+/**
+ * Tracks the required keys of the root object after a step of the parser
+ * at depth 1. Returns true once the values of all of them are complete.
+ */
+static bool jsmn_required_step(jsmn_parser *parser, const char *js,
+                               const jsmntok_t *tokens, const char c)
+{
+  jsmn_required *req = parser->required;
+  const jsmntok_t *last = &tokens[parser->toknext - 1];
+  unsigned int i;
+
+  if (c == '\"' && last->is_key) {
+    for (i = 0; i < req->nkeys; i++) {
+      if (jsmn_key_equal(js, last, req->keys[i], strlen(req->keys[i]))) {
+        req->pending = (uint32_t)1 << i;
+        break;
+      }
+    }
+    return false;
+  }
+  /* Whitespace and separators do not end a value */
+  if (c == ',' || c == ':' || jsmn_isspace(c) || req->pending == 0)
+    return false;
+  req->found |= req->pending;
+  req->pending = 0;
+  return req->found == (uint32_t)((((uint64_t)1) << req->nkeys) - 1);
+}
+
+/**
+ * Parse JSON string and fill tokens. If insitu is not NULL it aliases js and
+ * strings are decoded and terminated in place. js starts at offset base of
+ * the input: parser->pos is an offset into js, token offsets are into the
+ * input. Only jsmn_parse_iov() passes a base, and it rejects the options
+ * that read tokens back through js.
+ */
+#define JSMN_PARSER_ADVANCE(p,n) do { (p)->pos+=(n); (p)->col+=(n); } while (0)
+static inline enum jsmnerr jsmn_parse_impl(jsmn_parser *parser, const char *js,
+                                           const size_t len, jsmntok_t *tokens,
+                                           const unsigned int num_tokens,
+                                           char *insitu, const size_t base)
+{
+  enum jsmnerr r;
+  size_t slen;
+  jsmntok_t *token;
+  /* Where the work budget of this call runs out */
+  const size_t stop = parser->budget != 0 && len - parser->pos > parser->budget
+                          ? parser->pos + parser->budget
+                          : len;
+  const unsigned int tokstop = parser->tokbudget != 0
+                                   ? parser->toknext + parser->tokbudget
+                                   : (unsigned int)-1;
+
+  assert(tokens != NULL);
+
+  if (parser->tokbuf.type != JSMN_UNDEFINED) {
+    token = jsmn_alloc_token(parser, tokens, num_tokens);
+    if (token == NULL)
+      return JSMN_ERROR_NOMEM;
+    (void)memcpy(token, &parser->tokbuf, sizeof(*token));
+    parser->tokbuf.type = JSMN_UNDEFINED;
+    parser->tokbuf.unclosed = false;
+    parser->tokbuf.is_key = false;
+    parser->tokbuf.has_escapes = false;
+#ifdef JSMN_SYMTAB
+    parser->tokbuf.sym = JSMN_SYM_UNKNOWN;
+#endif
+#ifdef JSMN_NO_TRAILING_COMMAS
+    parser->__last_is_comma = false;
+#endif
+  }
+
+  /* Finish a value the last call stopped skipping partway */
+  if (parser->__skip_open != 0) {
+    r = jsmn_skip_resume(parser, js, len, stop);
+    if (r == JSMN_ERROR_UNEXPECTED_CHAR)
+      return r;
+    if (r != JSMN_SUCCESS)
+      goto skipped;
+    if (parser->__skip_opaque) {
+      parser->__skip_opaque = false;
+      tokens[parser->toknext - 1].end = base + parser->pos;
+      if (parser->required != NULL && parser->depth == 1 &&
+          jsmn_required_step(parser, js, tokens, '{'))
+        return JSMN_EARLY_EXIT;
+    }
+  }
+
+  for (; parser->pos < len && js[parser->pos] != '\0';) {
+    char c;
+    jsmntype_t type;
+    unsigned int line = parser->line;
+    unsigned int col = parser->col;
+    unsigned int start = parser->pos;
+
+    if (parser->pos >= stop || parser->toknext >= tokstop)
+      return JSMN_YIELD;
+    c = js[parser->pos];
+    /* Projection: drop array elements that no path selects */
+    if (parser->proj != NULL && parser->proj->all == 0 &&
+        parser->toksuper != -1 && tokens[parser->toksuper].type == JSMN_ARRAY &&
+        c != ']' && c != '}' && c != ',' && c != ':' && !jsmn_isspace(c)) {
+      int skip = jsmn_project_element(parser, js, len, stop, c);
+      if (skip == JSMN_ERROR_UNEXPECTED_EOF)
+        goto eof;
+      if (skip < 0)
+        return skip;
+      if (skip > 0) {
+        parser->__last_is_comma = false;
+        if (parser->__skip_open != 0)
+          goto skipped;
+        continue;
+      }
+    }
+    switch (c) {
+    case '{':
+    case '[':
 #ifndef JSMN_TESTMODE
       if (!parser->toknext && c != '{')
         return JSMN_ERROR_UNEXPECTED_CHAR;
 #endif
+      /* Reject containers past max_depth; opaque containers below
+       * parser->shallow are not opened and do not count */
+      if (parser->max_depth != 0 && parser->depth >= parser->max_depth &&
+          (parser->shallow == 0 || parser->depth < parser->shallow))
+        return JSMN_ERROR_TOO_DEEP;
       token = jsmn_alloc_token(parser, tokens, num_tokens);
       if (token == NULL) {
         return JSMN_ERROR_NOMEM;
@@ -282,9 +1335,30 @@ JSMN_API enum jsmnerr jsmn_parse(jsmn_parser *parser, const char *js, const size
         return JSMN_ERROR_EXPECTED_EOF;
       }
       token->type = (c == '{' ? JSMN_OBJECT : JSMN_ARRAY);
+      token->start = base + parser->pos;
+      /* Below the materialization depth: one token for the whole span */
+      if (parser->shallow != 0 && parser->depth >= parser->shallow) {
+        token->opaque = true;
+        token->size = 0;
+        r = jsmn_skip_value(parser, js, len, stop);
+        if (r == JSMN_ERROR_UNEXPECTED_CHAR)
+          return r;
+        if (r != JSMN_SUCCESS) {
+          /* The end is set once the skip is done */
+          parser->__skip_opaque = true;
+          break;
+        }
+        token->end = base + parser->pos;
+        break;
+      }
       token->unclosed = true;
-      token->start = parser->pos;
       parser->toksuper = parser->toknext - 1;
+      jsmn_open_push(parser, tokens, parser->toksuper);
+      parser->depth++;
+      if (parser->shapes != NULL && insitu == NULL)
+        jsmn_shape_open(parser, c == '{');
+      if (parser->proj != NULL)
+        jsmn_project_open(parser);
       JSMN_PARSER_ADVANCE(parser, 1);
       break;
     case '}':
@@ -307,6 +1381,8 @@ JSMN_API enum jsmnerr jsmn_parse(jsmn_parser *parser, const char *js, const size
             return JSMN_ERROR_UNEXPECTED_CHAR;
           }
           token->unclosed = false;
+          jsmn_open_pop(parser, token);
+          token->end = base + parser->pos + 1;
           parser->toksuper = token->parent;
           break;
         }
@@ -319,36 +1395,36 @@ JSMN_API enum jsmnerr jsmn_parse(jsmn_parser *parser, const char *js, const size
         token = &tokens[token->parent];
       }
 #else
-      token = &tokens[parser->toknext-1];
-      if (token->is_key)
-        return JSMN_ERROR_UNEXPECTED_CHAR;
-      for (i = parser->toknext - 1; i >= 0; i--) {
-        token = &tokens[i];
-        if (token->start != -1 && token->unclosed) {
-          if (token->type != type) {
-            return JSMN_ERROR_UNEXPECTED_CHAR;
-          }
-          parser->toksuper = -1;
-          token->unclosed = false;
-          break;
-        }
-      }
       /* Error if unmatched closing bracket */
-      if (i == -1) {
+      if (parser->tokopen == -1 || tokens[parser->toknext - 1].is_key)
+        return JSMN_ERROR_UNEXPECTED_CHAR;
+      token = &tokens[parser->tokopen];
+      if (token->type != type) {
         return JSMN_ERROR_UNEXPECTED_CHAR;
       }
-      for (; i >= 0; i--) {
-        token = &tokens[i];
-        if (token->start != -1 && token->unclosed) {
-          parser->toksuper = i;
-          break;
-        }
-      }
+      token->unclosed = false;
+      jsmn_open_pop(parser, token);
+      token->end = base + parser->pos + 1;
+      parser->toksuper = parser->tokopen;
 #endif
+      if (parser->depth > 0) {
+        if (parser->shapes != NULL && insitu == NULL)
+          jsmn_shape_close(parser);
+        if (parser->proj != NULL && parser->proj->all == parser->depth)
+          parser->proj->all = 0;
+        parser->depth--;
+      }
       JSMN_PARSER_ADVANCE(parser, 1);
       break;
     case '\"':
-      r = jsmn_parse_string(parser, js, len, tokens, num_tokens);
+      slen = parser->max_string != 0 &&
+                     len - parser->pos > parser->max_string + 2
+                 ? parser->pos + parser->max_string + 2
+                 : len;
+      r = jsmn_parse_string(parser, js, slen, tokens, num_tokens, insitu,
+                            base);
+      if (r == JSMN_ERROR_UNCLOSED_STRING && slen < len)
+        r = JSMN_ERROR_TOO_LONG;
       switch (r) {
       case JSMN_SUCCESS:
       case JSMN_ERROR_NOMEM:
@@ -375,6 +1451,36 @@ JSMN_API enum jsmnerr jsmn_parse(jsmn_parser *parser, const char *js, const size
             return JSMN_ERROR_UNEXPECTED_CHAR;
           }
         }
+        token = r == JSMN_SUCCESS ? &tokens[parser->toknext - 1]
+                                  : &parser->tokbuf;
+        /* Projection: drop keys that no path selects, with their values */
+        if (parser->proj != NULL && parser->proj->all == 0 &&
+            parser->toksuper != -1 &&
+            tokens[parser->toksuper].type == JSMN_OBJECT) {
+          int skip = jsmn_project_key(parser, js, len, stop, token);
+          if (skip != 0) {
+            if (r == JSMN_SUCCESS)
+              parser->toknext--;
+            else
+              jsmn_init_token(&parser->tokbuf);
+            tokens[parser->toksuper].size--;
+            token = NULL;
+            r = JSMN_SUCCESS;
+          }
+          if (skip == JSMN_ERROR_UNEXPECTED_EOF) {
+            parser->line = line;
+            parser->col = col;
+            parser->pos = start;
+            goto eof;
+          }
+          if (skip < 0)
+            return skip;
+        }
+        if (insitu != NULL && token != NULL) {
+          enum jsmnerr e = jsmn_insitu_string(insitu, token);
+          if (e != JSMN_SUCCESS)
+            return e;
+        }
       default:
         if (r != JSMN_SUCCESS)
           return r;
@@ -386,8 +1492,11 @@ JSMN_API enum jsmnerr jsmn_parse(jsmn_parser *parser, const char *js, const size
     case '\t':
     case '\f':
     case '\v':
-      if (jamn_skip_whitespaces(parser, js, len))
+      r = jamn_skip_whitespaces(parser, js, len);
+      if (r < 0)
         return JSMN_ERROR_BROKEN_NEWLINE;
+      if (r > 0)
+        goto eof;
       break;
     case ':':
       if (!tokens[parser->toknext-1].is_key) {
@@ -409,14 +1518,7 @@ JSMN_API enum jsmnerr jsmn_parse(jsmn_parser *parser, const char *js, const size
 #ifdef JSMN_PARENT_LINKS
           parser->toksuper = tokens[parser->toksuper].parent;
 #else
-          for (i = parser->toknext - 1; i >= 0; i--) {
-            if (tokens[i].type == JSMN_ARRAY || tokens[i].type == JSMN_OBJECT) {
-              if (tokens[i].start != -1 && tokens[i].unclosed) {
-                parser->toksuper = i;
-                break;
-              }
-            }
-          }
+          parser->toksuper = parser->tokopen;
 #endif
         }
       }
@@ -444,7 +1546,8 @@ JSMN_API enum jsmnerr jsmn_parse(jsmn_parser *parser, const char *js, const size
           return JSMN_ERROR_INVAL;
         }
       }
-      r = jsmn_parse_primitive(parser, js, len, tokens, num_tokens);
+      r = jsmn_parse_primitive(parser, js, len, tokens, num_tokens, insitu,
+                               base);
       switch (r) {
       case JSMN_SUCCESS:
       case JSMN_ERROR_NOMEM:
@@ -480,22 +1583,376 @@ JSMN_API enum jsmnerr jsmn_parse(jsmn_parser *parser, const char *js, const size
     default:
       return JSMN_ERROR_INVAL;
     }
+    if (parser->__insitu_nul != 0 && parser->__insitu_nul < parser->pos) {
+      insitu[parser->__insitu_nul] = '\0';
+      parser->__insitu_nul = 0;
+    }
     parser->__last_is_comma = (c == ',');
-  }
-
-  if (tokens != NULL) {
-    for (i = parser->toknext - 1; i >= 0; i--) {
-      /* Unmatched opened object or array */
-      if (tokens[i].start != -1 && tokens[i].unclosed) {
-        return tokens[i].type == JSMN_OBJECT ? JSMN_ERROR_UNCLOSED_OBJECT :
-                                               JSMN_ERROR_UNCLOSED_ARRAY;
+    if (parser->__skip_open != 0)
+      goto skipped;
+    if (parser->required != NULL && parser->depth == 1 &&
+        parser->toknext > 0 && jsmn_required_step(parser, js, tokens, c)) {
+      /* The pending terminator's delimiter will never be consumed */
+      if (parser->__insitu_nul != 0) {
+        insitu[parser->__insitu_nul] = '\0';
+        parser->__insitu_nul = 0;
+      }
+      return JSMN_EARLY_EXIT;
+    }
+    /* Stream mode: hand each complete top-level value to the caller */
+    if ((parser->flags & JSMN_STREAM) && parser->depth == 0 &&
+        parser->toknext > 0) {
+      if (parser->__insitu_nul != 0) {
+        insitu[parser->__insitu_nul] = '\0';
+        parser->__insitu_nul = 0;
       }
+      return JSMN_SUCCESS;
     }
   }
+
+skipped:
+  /* A skip stopped by the budget, or else by the end of the input */
+  if (parser->pos >= stop && stop < len)
+    return JSMN_YIELD;
+eof:
+  /* Unmatched opened object or array */
+  if (parser->tokopen != -1)
+    return tokens[parser->tokopen].type == JSMN_OBJECT
+               ? JSMN_ERROR_UNCLOSED_OBJECT
+               : JSMN_ERROR_UNCLOSED_ARRAY;
   return JSMN_SUCCESS;
 }
 #undef JSMN_PARSER_ADVANCE
 
+static inline bool jsmn_incomplete(const enum jsmnerr r)
+{
+  return r == JSMN_ERROR_UNEXPECTED_EOF || r == JSMN_ERROR_UNCLOSED_STRING ||
+         r == JSMN_ERROR_UNCLOSED_OBJECT || r == JSMN_ERROR_UNCLOSED_ARRAY;
+}
+
+/**
+ * A stream mode parser stopped at the end of a top-level value.
+ */
+static inline bool jsmn_stream_done(const jsmn_parser *parser,
+                                    const enum jsmnerr r)
+{
+  return r == JSMN_SUCCESS && (parser->flags & JSMN_STREAM) &&
+         parser->depth == 0 && parser->toknext > 0;
+}
+
+/**
+ * The limit is on the document, not the input: once the root value has
+ * closed at the byte cut, whitespace may follow it up to len.
+ */
+static bool jsmn_trailing_space(jsmn_parser *parser, const char *js,
+                                const size_t len)
+{
+  int ws;
+
+  if (parser->depth != 0 || parser->toknext == 0)
+    return false;
+  if (parser->pos < len && jsmn_isspace(js[parser->pos])) {
+    ws = jamn_skip_whitespaces(parser, js, len);
+    if (ws != 0)
+      return ws > 0;
+  }
+  return parser->pos >= len || js[parser->pos] == '\0';
+}
+
+/**
+ * Enforces the token and byte limits by cutting the token array and the
+ * input short: running into the cut is an error instead of a request for
+ * more, and the parser never looks past it.
+ */
+static enum jsmnerr jsmn_parse_limited(jsmn_parser *parser, const char *js,
+                                       const size_t len, jsmntok_t *tokens,
+                                       const unsigned int num_tokens,
+                                       char *insitu, const size_t base)
+{
+  const bool tokcut =
+      parser->max_tokens != 0 && parser->max_tokens <= num_tokens;
+  const bool bytecut = parser->max_bytes != 0 && base + len > parser->max_bytes;
+  const enum jsmnerr r = jsmn_parse_impl(
+      parser, js,
+      !bytecut ? len : parser->max_bytes > base ? parser->max_bytes - base : 0,
+      tokens, tokcut ? parser->max_tokens : num_tokens, insitu, base);
+
+  if (r == JSMN_ERROR_NOMEM && tokcut &&
+      parser->toknext >= parser->max_tokens)
+    return JSMN_ERROR_TOO_MANY_TOKENS;
+  if (bytecut &&
+      (jsmn_incomplete(r) ||
+       (r == JSMN_SUCCESS && base + parser->pos >= parser->max_bytes &&
+        !jsmn_stream_done(parser, r) &&
+        !jsmn_trailing_space(parser, js, len))))
+    return JSMN_ERROR_TOO_BIG;
+  return r;
+}
+
+JSMN_API enum jsmnerr jsmn_parse(jsmn_parser *parser, const char *js, const size_t len,
+                        jsmntok_t *tokens, const unsigned int num_tokens)
+{
+  return jsmn_parse_limited(parser, js, len, tokens, num_tokens, NULL, 0);
+}
+
+/**
+ * Destructive variant of jsmn_parse(), see jsmn2.h.
+ */
+JSMN_API enum jsmnerr jsmn_parse_insitu(jsmn_parser *parser, char *js,
+                                        const size_t len, jsmntok_t *tokens,
+                                        const unsigned int num_tokens)
+{
+  return jsmn_parse_limited(parser, js, len, tokens, num_tokens, js, 0);
+}
+
+/**
+ * Parses the span of an opaque token as if it was the whole document.
+ */
+JSMN_API enum jsmnerr jsmn_expand(jsmn_parser *parser, const char *js,
+                                  const jsmntok_t *opaque, jsmntok_t *tokens,
+                                  const unsigned int num_tokens)
+{
+  jsmntok_t *token;
+
+  if (!opaque->opaque || parser->toknext != 0)
+    return JSMN_ERROR_INVAL;
+  /* Open the root by hand, it may be an array */
+  token = jsmn_alloc_token(parser, tokens, num_tokens);
+  if (token == NULL)
+    return JSMN_ERROR_NOMEM;
+  token->type = opaque->type;
+  token->start = opaque->start;
+  token->unclosed = true;
+  parser->toksuper = 0;
+  jsmn_open_push(parser, tokens, 0);
+  parser->pos = opaque->start;
+  parser->depth = 1;
+  if (parser->shapes != NULL)
+    jsmn_shape_open(parser, opaque->type == JSMN_OBJECT);
+  if (parser->proj != NULL)
+    jsmn_project_open(parser);
+  parser->pos++;
+  parser->col++;
+  return jsmn_parse_limited(parser, js, opaque->end, tokens, num_tokens, NULL,
+                            0);
+}
+
+/*
+ * Scattered input.
+ */
+
+/**
+ * Runs the parser over the bytes at js, which start at offset off of the
+ * input and run up to offset end, with what is left of the budgets of the
+ * jsmn_parse_iov() call that started at pos from with first tokens. The
+ * parser position is made relative to js for the call.
+ */
+static enum jsmnerr jsmn_iov_parse(jsmn_parser *parser, const char *js,
+                                   const size_t off, const size_t end,
+                                   jsmntok_t *tokens,
+                                   const unsigned int num_tokens,
+                                   const size_t from, const unsigned int first)
+{
+  const unsigned int budget = parser->budget, tokbudget = parser->tokbudget;
+  enum jsmnerr r;
+
+  if ((budget != 0 && parser->pos - from >= budget) ||
+      (tokbudget != 0 && parser->toknext - first >= tokbudget))
+    return JSMN_YIELD;
+  if (budget != 0)
+    parser->budget = budget - (parser->pos - from);
+  if (tokbudget != 0)
+    parser->tokbudget = tokbudget - (parser->toknext - first);
+  parser->pos -= off;
+  r = jsmn_parse_limited(parser, js, end - off, tokens, num_tokens, NULL, off);
+  parser->pos += off;
+  parser->budget = budget;
+  parser->tokbudget = tokbudget;
+  return r;
+}
+
+/**
+ * Flags the strings and primitives from tokens[first] on whose span crosses
+ * a segment boundary. Tokens are in document order, so the segment of
+ * their start only moves ahead.
+ */
+static void jsmn_iov_mark(const jsmn_iovec *iov, const unsigned int n,
+                          jsmntok_t *tokens, const unsigned int first,
+                          const unsigned int count)
+{
+  size_t off = 0;
+  unsigned int k = 0, i;
+
+  for (i = first; i < count; i++) {
+    jsmntok_t *t = &tokens[i];
+    if (t->type == JSMN_OBJECT || t->type == JSMN_ARRAY)
+      continue;
+    while (k + 1 < n && t->start >= off + iov[k].len) {
+      off += iov[k].len;
+      k++;
+    }
+    t->split = t->end > off + iov[k].len;
+  }
+}
+
+/**
+ * Parses each segment in place. When the parser stops short of a segment
+ * end, a token is cut by the boundary: the bytes from there on are copied
+ * into the scratch buffer and parsed from it until the parser is past the
+ * boundary.
+ */
+JSMN_API enum jsmnerr jsmn_parse_iov(jsmn_parser *parser,
+                                     const jsmn_iovec *iov, const unsigned int n,
+                                     jsmntok_t *tokens,
+                                     const unsigned int num_tokens,
+                                     char *scratch, const size_t scratchcap)
+{
+  enum jsmnerr r = JSMN_SUCCESS;
+  size_t off = 0, end;
+  unsigned int k = 0;
+  const unsigned int first = parser->toknext;
+  const size_t from = parser->pos;
+
+  if (parser->proj != NULL || parser->required != NULL ||
+      parser->shapes != NULL || parser->shallow != 0)
+    return JSMN_ERROR_INVAL;
+
+  while (k < n) {
+    size_t fill = 0, at;
+    unsigned int j;
+
+    end = off + iov[k].len;
+    if (parser->pos >= end) {
+      off = end;
+      k++;
+      continue;
+    }
+    r = jsmn_iov_parse(parser, iov[k].base, off, end, tokens, num_tokens, from,
+                       first);
+    if ((r < 0 && !jsmn_incomplete(r)) || r == JSMN_YIELD ||
+        jsmn_stream_done(parser, r))
+      break;
+    /* Stopped inside the last segment or at a NUL: wait for more input */
+    if (parser->pos >= end)
+      continue;
+    if (k + 1 == n ||
+        ((const char *)iov[k].base)[parser->pos - off] == '\0')
+      break;
+
+    /* Bridge the boundary */
+    at = parser->pos - off;
+    for (j = k; j < n && fill < scratchcap; j++, at = 0) {
+      size_t take = iov[j].len - at;
+      if (take > scratchcap - fill)
+        take = scratchcap - fill;
+      (void)memcpy(scratch + fill, (const char *)iov[j].base + at, take);
+      fill += take;
+    }
+    r = jsmn_iov_parse(parser, scratch, parser->pos, parser->pos + fill,
+                       tokens, num_tokens, from, first);
+    if ((r < 0 && !jsmn_incomplete(r)) || r == JSMN_YIELD ||
+        jsmn_stream_done(parser, r))
+      break;
+    if (parser->pos < end) {
+      /* Everything that is left was in scratch, so more input is needed */
+      if (j < n || fill == scratchcap)
+        r = JSMN_ERROR_NOMEM;
+      break;
+    }
+  }
+  jsmn_iov_mark(iov, n, tokens, first, parser->toknext);
+  return r;
+}
+
+/**
+ * Points into the token's segment or gathers it from all of them. The
+ * split flag is not trusted, containers never get it.
+ */
+JSMN_API const char *jsmn_iov_span(const jsmn_iovec *iov, const unsigned int n,
+                                   const jsmntok_t *tok, char *out,
+                                   const size_t cap)
+{
+  size_t off = 0, at = tok->start, o = 0, len;
+  unsigned int k = 0;
+
+  if (tok->unclosed)
+    return NULL;
+  if (tok->end == tok->start)
+    return "";
+  len = tok->end - tok->start;
+  while (k < n && at >= off + iov[k].len) {
+    off += iov[k].len;
+    k++;
+  }
+  if (k == n)
+    return NULL;
+  if (tok->end <= off + iov[k].len)
+    return (const char *)iov[k].base + (at - off);
+  if (len > cap)
+    return NULL;
+  for (; o < len && k < n; k++) {
+    size_t take = iov[k].len - (at - off);
+    if (take > len - o)
+      take = len - o;
+    (void)memcpy(out + o, (const char *)iov[k].base + (at - off), take);
+    o += take;
+    at += take;
+    off += iov[k].len;
+  }
+  return o == len ? out : NULL;
+}
+
+/**
+ * Shifts the parser state down by n tokens and skip bytes.
+ */
+JSMN_API enum jsmnerr jsmn_discard(jsmn_parser *parser, jsmntok_t *tokens,
+                                   const unsigned int n, const size_t skip)
+{
+  unsigned int i;
+
+  if (parser->proj != NULL || parser->required != NULL ||
+      parser->shapes != NULL || n > parser->toknext || skip > parser->pos ||
+      (parser->toksuper != -1 && (unsigned int)parser->toksuper < n) ||
+      (n < parser->toknext && tokens[n].start < skip) ||
+      (parser->tokbuf.type != JSMN_UNDEFINED && parser->tokbuf.start < skip))
+    return JSMN_ERROR_INVAL;
+  /* The dropped tokens must not leave an open container behind */
+  if (n == parser->toknext && parser->depth != 0)
+    return JSMN_ERROR_INVAL;
+
+  parser->toknext -= n;
+  (void)memmove(tokens, tokens + n, parser->toknext * sizeof(*tokens));
+  for (i = 0; i < parser->toknext; i++) {
+    tokens[i].start -= skip;
+    /* Open containers link to the enclosing one by index */
+    if (tokens[i].unclosed)
+      tokens[i].end -= tokens[i].end == (size_t)-1 ? 0 : n;
+    else if (tokens[i].end != (size_t)-1)
+      tokens[i].end -= skip;
+#ifdef JSMN_PARENT_LINKS
+    if (tokens[i].parent != -1)
+      tokens[i].parent -= n;
+#endif
+  }
+  if (parser->tokbuf.type != JSMN_UNDEFINED) {
+    parser->tokbuf.start -= skip;
+    if (parser->tokbuf.end != (size_t)-1)
+      parser->tokbuf.end -= skip;
+#ifdef JSMN_PARENT_LINKS
+    if (parser->tokbuf.parent != -1)
+      parser->tokbuf.parent -= n;
+#endif
+  }
+  if (parser->toksuper != -1)
+    parser->toksuper -= n;
+  if (parser->tokopen != -1)
+    parser->tokopen -= n;
+  if (parser->__insitu_nul != 0)
+    parser->__insitu_nul -= skip;
+  parser->pos -= skip;
+  return JSMN_SUCCESS;
+}
+
 /**
  * Creates a new parser based over a given buffer with an array of tokens
  * available.
@@ -506,7 +1963,3475 @@ JSMN_API void jsmn_init(jsmn_parser *parser) {
   parser->col = 1;
   parser->line = 1;
   parser->toksuper = -1;
+  parser->tokopen = -1;
   parser->__last_is_comma = false;
+  parser->__skip_str = false;
+  parser->__skip_opaque = false;
+  parser->__skip_open = 0;
+  parser->__skip_depth = 0;
+  parser->__insitu_nul = 0;
+  parser->flags = 0;
+  parser->depth = 0;
+  parser->shallow = 0;
+  parser->budget = 0;
+  parser->tokbudget = 0;
+  parser->max_depth = 0;
+  parser->max_string = 0;
+  parser->max_tokens = 0;
+  parser->max_bytes = 0;
+  parser->shapes = NULL;
+  parser->proj = NULL;
+  parser->required = NULL;
+#ifdef JSMN_SYMTAB
+  parser->symtab = NULL;
+#endif
   jsmn_init_token(&parser->tokbuf);
 }
 
+
+/*
+ * Numeric decoding.
+ *
+ * Primitive tokens are validated against the JSON number grammar and decoded
+ * straight from the token span, so the input neither has to be NUL-terminated
+ * nor is the result affected by the current locale.
+ */
+
+static inline bool jsmn_is_eight_digits(const uint64_t v)
+{
+  return (((v + 0x4646464646464646ULL) | (v - 0x3030303030303030ULL)) &
+          0x8080808080808080ULL) == 0;
+}
+
+/**
+ * Converts 8 ASCII digits loaded with jsmn_read64le() in one go.
+ */
+static inline uint32_t jsmn_parse_eight_digits(uint64_t v)
+{
+  const uint64_t mask = 0x000000FF000000FFULL;
+  const uint64_t mul1 = 0x000F424000000064ULL; /* 100 + (1000000 << 32) */
+  const uint64_t mul2 = 0x0000271000000001ULL; /* 1 + (10000 << 32) */
+
+  v -= 0x3030303030303030ULL;
+  v = (v * 10) + (v >> 8);
+  v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+  return (uint32_t)v;
+}
+
+static inline int jsmn_clz64(uint64_t v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_clzll(v);
+#else
+  int n = 0;
+  for (; !(v & 0x8000000000000000ULL); v <<= 1)
+    n++;
+  return n;
+#endif
+}
+
+/**
+ * Full 64x64 -> 128 bit multiplication, returns the high half.
+ */
+static inline uint64_t jsmn_mul128(const uint64_t a, const uint64_t b,
+                                   uint64_t *lo)
+{
+#if defined(__SIZEOF_INT128__)
+  __extension__ unsigned __int128 r = (unsigned __int128)a * b;
+  *lo = (uint64_t)r;
+  return (uint64_t)(r >> 64);
+#else
+  uint64_t a0 = a & 0xFFFFFFFF, a1 = a >> 32;
+  uint64_t b0 = b & 0xFFFFFFFF, b1 = b >> 32;
+  uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+  uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+  *lo = (mid << 32) | (p00 & 0xFFFFFFFF);
+  return p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+}
+
+/**
+ * A JSON number split into its parts. mant holds the first 19 significant
+ * digits so that the value is mant * 10^exp10 unless trunc is set.
+ */
+struct jsmn_number {
+  uint64_t mant;
+  int exp10;
+  int exp;            /* explicit exponent, clamped */
+  bool neg;
+  bool trunc;         /* nonzero digits did not fit into mant */
+  bool integral;      /* neither fraction nor exponent */
+  const char *ib, *ie; /* integer digits */
+  const char *fb, *fe; /* fraction digits */
+};
+
+#define JSMN_MANT_DIGITS 19
+#define JSMN_EXP_CLAMP 100000
+
+/**
+ * Validates s[0..n) against the JSON number grammar and collects its
+ * significant digits in a single pass.
+ */
+static bool jsmn_scan_number(const char *s, const size_t n,
+                             struct jsmn_number *num)
+{
+  const char *p = s;
+  const char *e = s + n;
+  uint64_t mant = 0;
+  int nd = 0;
+  int exp10 = 0;
+
+  num->trunc = false;
+  num->neg = (p < e && *p == '-');
+  p += num->neg;
+  if (p == e || !jsmn_isdigit(*p))
+    return false;
+
+  num->ib = p;
+  if (*p == '0') {
+    p++;
+  } else {
+    for (; e - p >= 8 && nd + 8 <= JSMN_MANT_DIGITS &&
+           jsmn_is_eight_digits(jsmn_read64le(p));
+         p += 8, nd += 8)
+      mant = mant * 100000000 + jsmn_parse_eight_digits(jsmn_read64le(p));
+    for (; p < e && jsmn_isdigit(*p); p++) {
+      if (nd < JSMN_MANT_DIGITS) {
+        mant = mant * 10 + (uint64_t)(*p - '0');
+        nd++;
+      } else {
+        exp10++;
+        num->trunc |= (*p != '0');
+      }
+    }
+  }
+  num->ie = p;
+  num->fb = num->fe = p;
+
+  if (p < e && *p == '.') {
+    num->fb = ++p;
+    if (nd == 0) {
+      for (; p < e && *p == '0'; p++)
+        exp10--;
+    }
+    for (; e - p >= 8 && nd + 8 <= JSMN_MANT_DIGITS &&
+           jsmn_is_eight_digits(jsmn_read64le(p));
+         p += 8, nd += 8, exp10 -= 8)
+      mant = mant * 100000000 + jsmn_parse_eight_digits(jsmn_read64le(p));
+    for (; p < e && jsmn_isdigit(*p); p++) {
+      if (nd < JSMN_MANT_DIGITS) {
+        mant = mant * 10 + (uint64_t)(*p - '0');
+        nd++;
+        exp10--;
+      } else {
+        num->trunc |= (*p != '0');
+      }
+    }
+    num->fe = p;
+    if (num->fe == num->fb)
+      return false;
+  }
+
+  num->exp = 0;
+  if (p < e && (*p | 0x20) == 'e') {
+    bool eneg = false;
+    p++;
+    if (p < e && (*p == '+' || *p == '-'))
+      eneg = (*p++ == '-');
+    if (p == e || !jsmn_isdigit(*p))
+      return false;
+    for (; p < e && jsmn_isdigit(*p); p++) {
+      if (num->exp < JSMN_EXP_CLAMP)
+        num->exp = num->exp * 10 + (*p - '0');
+    }
+    if (eneg)
+      num->exp = -num->exp;
+  }
+
+  num->integral = (num->fb == num->ie && p == num->ie);
+  num->mant = mant;
+  num->exp10 = exp10 + num->exp;
+  return p == e;
+}
+
+static enum jsmnerr jsmn_token_number(const char *js, const jsmntok_t *tok,
+                                      struct jsmn_number *num)
+{
+  if (tok->type != JSMN_PRIMITIVE ||
+      !jsmn_scan_number(js + tok->start, tok->size, num))
+    return JSMN_ERROR_NOT_NUMBER;
+  return JSMN_SUCCESS;
+}
+
+/**
+ * Magnitude of an integral number, fails if it does not fit into 64 bits.
+ */
+static enum jsmnerr jsmn_number_magnitude(const struct jsmn_number *num,
+                                          uint64_t *out)
+{
+  const size_t nint = num->ie - num->ib;
+  uint64_t d;
+
+  if (!num->integral)
+    return JSMN_ERROR_NOT_INTEGER;
+  if (nint <= JSMN_MANT_DIGITS) {
+    *out = num->mant;
+    return JSMN_SUCCESS;
+  }
+  if (nint > JSMN_MANT_DIGITS + 1)
+    return JSMN_ERROR_RANGE;
+  /* Exactly 20 digits: mant holds the first 19 */
+  d = (uint64_t)(num->ie[-1] - '0');
+  if (num->mant > (UINT64_MAX - d) / 10)
+    return JSMN_ERROR_RANGE;
+  *out = num->mant * 10 + d;
+  return JSMN_SUCCESS;
+}
+
+/**
+ * Decodes an integral number token as an unsigned 64-bit integer.
+ */
+JSMN_API enum jsmnerr jsmn_get_u64(const char *js, const jsmntok_t *tok,
+                                   uint64_t *out)
+{
+  struct jsmn_number num;
+  uint64_t v;
+  enum jsmnerr r;
+
+  if ((r = jsmn_token_number(js, tok, &num)) != JSMN_SUCCESS)
+    return r;
+  if ((r = jsmn_number_magnitude(&num, &v)) != JSMN_SUCCESS)
+    return r;
+  if (num.neg && v != 0)
+    return JSMN_ERROR_RANGE;
+  *out = v;
+  return JSMN_SUCCESS;
+}
+
+static enum jsmnerr jsmn_number_to_i64(const struct jsmn_number *num,
+                                       int64_t *out)
+{
+  uint64_t v;
+  enum jsmnerr r;
+
+  if ((r = jsmn_number_magnitude(num, &v)) != JSMN_SUCCESS)
+    return r;
+  if (num->neg) {
+    if (v > (uint64_t)INT64_MAX + 1)
+      return JSMN_ERROR_RANGE;
+    *out = (v == (uint64_t)INT64_MAX + 1) ? INT64_MIN : -(int64_t)v;
+  } else {
+    if (v > (uint64_t)INT64_MAX)
+      return JSMN_ERROR_RANGE;
+    *out = (int64_t)v;
+  }
+  return JSMN_SUCCESS;
+}
+
+/**
+ * Decodes an integral number token as a signed 64-bit integer.
+ */
+JSMN_API enum jsmnerr jsmn_get_i64(const char *js, const jsmntok_t *tok,
+                                   int64_t *out)
+{
+  struct jsmn_number num;
+  enum jsmnerr r;
+
+  if ((r = jsmn_token_number(js, tok, &num)) != JSMN_SUCCESS)
+    return r;
+  return jsmn_number_to_i64(&num, out);
+}
+
+static inline double jsmn_f64_from_bits(const uint64_t bits)
+{
+  double f;
+  (void)memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+static const double jsmn_pow10_f64[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/**
+ * Clinger's fast path: both the mantissa and the power of ten are exactly
+ * representable, so a single IEEE operation rounds correctly.
+ */
+static bool jsmn_f64_exact(const uint64_t mant, int exp10, const bool neg,
+                           double *out)
+{
+  double f;
+
+  if (mant >> 53)
+    return false;
+  f = (double)mant;
+  if (neg)
+    f = -f;
+  if (exp10 == 0) {
+    *out = f;
+    return true;
+  }
+  if (exp10 > 0 && exp10 <= 15 + 22) {
+    /* Move a few zeros into the mantissa if it stays exact */
+    if (exp10 > 22) {
+      f *= jsmn_pow10_f64[exp10 - 22];
+      exp10 = 22;
+    }
+    if (f > 1e15 || f < -1e15)
+      return false;
+    *out = f * jsmn_pow10_f64[exp10];
+    return true;
+  }
+  if (exp10 < 0 && exp10 >= -22) {
+    *out = f / jsmn_pow10_f64[-exp10];
+    return true;
+  }
+  return false;
+}
+
+#define JSMN_POW5_MIN -342
+#define JSMN_POW5_MAX 308
+
+/**
+ * 128-bit approximations of 5^q (equivalently 10^q), normalized so that the
+ * most significant bit is set, stored as {high, low}.
+ */
+static const uint64_t jsmn_pow5_128[JSMN_POW5_MAX - JSMN_POW5_MIN + 1][2] = {
+    {0xEEF453D6923BD65AULL, 0x113FAA2906A13B3FULL}, /* 5^-342 */
+    {0x9558B4661B6565F8ULL, 0x4AC7CA59A424C507ULL}, /* 5^-341 */
+    {0xBAAEE17FA23EBF76ULL, 0x5D79BCF00D2DF649ULL}, /* 5^-340 */
+    {0xE95A99DF8ACE6F53ULL, 0xF4D82C2C107973DCULL}, /* 5^-339 */
+    {0x91D8A02BB6C10594ULL, 0x79071B9B8A4BE869ULL}, /* 5^-338 */
+    {0xB64EC836A47146F9ULL, 0x9748E2826CDEE284ULL}, /* 5^-337 */
+    {0xE3E27A444D8D98B7ULL, 0xFD1B1B2308169B25ULL}, /* 5^-336 */
+    {0x8E6D8C6AB0787F72ULL, 0xFE30F0F5E50E20F7ULL}, /* 5^-335 */
+    {0xB208EF855C969F4FULL, 0xBDBD2D335E51A935ULL}, /* 5^-334 */
+    {0xDE8B2B66B3BC4723ULL, 0xAD2C788035E61382ULL}, /* 5^-333 */
+    {0x8B16FB203055AC76ULL, 0x4C3BCB5021AFCC31ULL}, /* 5^-332 */
+    {0xADDCB9E83C6B1793ULL, 0xDF4ABE242A1BBF3DULL}, /* 5^-331 */
+    {0xD953E8624B85DD78ULL, 0xD71D6DAD34A2AF0DULL}, /* 5^-330 */
+    {0x87D4713D6F33AA6BULL, 0x8672648C40E5AD68ULL}, /* 5^-329 */
+    {0xA9C98D8CCB009506ULL, 0x680EFDAF511F18C2ULL}, /* 5^-328 */
+    {0xD43BF0EFFDC0BA48ULL, 0x0212BD1B2566DEF2ULL}, /* 5^-327 */
+    {0x84A57695FE98746DULL, 0x014BB630F7604B57ULL}, /* 5^-326 */
+    {0xA5CED43B7E3E9188ULL, 0x419EA3BD35385E2DULL}, /* 5^-325 */
+    {0xCF42894A5DCE35EAULL, 0x52064CAC828675B9ULL}, /* 5^-324 */
+    {0x818995CE7AA0E1B2ULL, 0x7343EFEBD1940993ULL}, /* 5^-323 */
+    {0xA1EBFB4219491A1FULL, 0x1014EBE6C5F90BF8ULL}, /* 5^-322 */
+    {0xCA66FA129F9B60A6ULL, 0xD41A26E077774EF6ULL}, /* 5^-321 */
+    {0xFD00B897478238D0ULL, 0x8920B098955522B4ULL}, /* 5^-320 */
+    {0x9E20735E8CB16382ULL, 0x55B46E5F5D5535B0ULL}, /* 5^-319 */
+    {0xC5A890362FDDBC62ULL, 0xEB2189F734AA831DULL}, /* 5^-318 */
+    {0xF712B443BBD52B7BULL, 0xA5E9EC7501D523E4ULL}, /* 5^-317 */
+    {0x9A6BB0AA55653B2DULL, 0x47B233C92125366EULL}, /* 5^-316 */
+    {0xC1069CD4EABE89F8ULL, 0x999EC0BB696E840AULL}, /* 5^-315 */
+    {0xF148440A256E2C76ULL, 0xC00670EA43CA250DULL}, /* 5^-314 */
+    {0x96CD2A865764DBCAULL, 0x380406926A5E5728ULL}, /* 5^-313 */
+    {0xBC807527ED3E12BCULL, 0xC605083704F5ECF2ULL}, /* 5^-312 */
+    {0xEBA09271E88D976BULL, 0xF7864A44C633682EULL}, /* 5^-311 */
+    {0x93445B8731587EA3ULL, 0x7AB3EE6AFBE0211DULL}, /* 5^-310 */
+    {0xB8157268FDAE9E4CULL, 0x5960EA05BAD82964ULL}, /* 5^-309 */
+    {0xE61ACF033D1A45DFULL, 0x6FB92487298E33BDULL}, /* 5^-308 */
+    {0x8FD0C16206306BABULL, 0xA5D3B6D479F8E056ULL}, /* 5^-307 */
+    {0xB3C4F1BA87BC8696ULL, 0x8F48A4899877186CULL}, /* 5^-306 */
+    {0xE0B62E2929ABA83CULL, 0x331ACDABFE94DE87ULL}, /* 5^-305 */
+    {0x8C71DCD9BA0B4925ULL, 0x9FF0C08B7F1D0B14ULL}, /* 5^-304 */
+    {0xAF8E5410288E1B6FULL, 0x07ECF0AE5EE44DD9ULL}, /* 5^-303 */
+    {0xDB71E91432B1A24AULL, 0xC9E82CD9F69D6150ULL}, /* 5^-302 */
+    {0x892731AC9FAF056EULL, 0xBE311C083A225CD2ULL}, /* 5^-301 */
+    {0xAB70FE17C79AC6CAULL, 0x6DBD630A48AAF406ULL}, /* 5^-300 */
+    {0xD64D3D9DB981787DULL, 0x092CBBCCDAD5B108ULL}, /* 5^-299 */
+    {0x85F0468293F0EB4EULL, 0x25BBF56008C58EA5ULL}, /* 5^-298 */
+    {0xA76C582338ED2621ULL, 0xAF2AF2B80AF6F24EULL}, /* 5^-297 */
+    {0xD1476E2C07286FAAULL, 0x1AF5AF660DB4AEE1ULL}, /* 5^-296 */
+    {0x82CCA4DB847945CAULL, 0x50D98D9FC890ED4DULL}, /* 5^-295 */
+    {0xA37FCE126597973CULL, 0xE50FF107BAB528A0ULL}, /* 5^-294 */
+    {0xCC5FC196FEFD7D0CULL, 0x1E53ED49A96272C8ULL}, /* 5^-293 */
+    {0xFF77B1FCBEBCDC4FULL, 0x25E8E89C13BB0F7AULL}, /* 5^-292 */
+    {0x9FAACF3DF73609B1ULL, 0x77B191618C54E9ACULL}, /* 5^-291 */
+    {0xC795830D75038C1DULL, 0xD59DF5B9EF6A2417ULL}, /* 5^-290 */
+    {0xF97AE3D0D2446F25ULL, 0x4B0573286B44AD1DULL}, /* 5^-289 */
+    {0x9BECCE62836AC577ULL, 0x4EE367F9430AEC32ULL}, /* 5^-288 */
+    {0xC2E801FB244576D5ULL, 0x229C41F793CDA73FULL}, /* 5^-287 */
+    {0xF3A20279ED56D48AULL, 0x6B43527578C1110FULL}, /* 5^-286 */
+    {0x9845418C345644D6ULL, 0x830A13896B78AAA9ULL}, /* 5^-285 */
+    {0xBE5691EF416BD60CULL, 0x23CC986BC656D553ULL}, /* 5^-284 */
+    {0xEDEC366B11C6CB8FULL, 0x2CBFBE86B7EC8AA8ULL}, /* 5^-283 */
+    {0x94B3A202EB1C3F39ULL, 0x7BF7D71432F3D6A9ULL}, /* 5^-282 */
+    {0xB9E08A83A5E34F07ULL, 0xDAF5CCD93FB0CC53ULL}, /* 5^-281 */
+    {0xE858AD248F5C22C9ULL, 0xD1B3400F8F9CFF68ULL}, /* 5^-280 */
+    {0x91376C36D99995BEULL, 0x23100809B9C21FA1ULL}, /* 5^-279 */
+    {0xB58547448FFFFB2DULL, 0xABD40A0C2832A78AULL}, /* 5^-278 */
+    {0xE2E69915B3FFF9F9ULL, 0x16C90C8F323F516CULL}, /* 5^-277 */
+    {0x8DD01FAD907FFC3BULL, 0xAE3DA7D97F6792E3ULL}, /* 5^-276 */
+    {0xB1442798F49FFB4AULL, 0x99CD11CFDF41779CULL}, /* 5^-275 */
+    {0xDD95317F31C7FA1DULL, 0x40405643D711D583ULL}, /* 5^-274 */
+    {0x8A7D3EEF7F1CFC52ULL, 0x482835EA666B2572ULL}, /* 5^-273 */
+    {0xAD1C8EAB5EE43B66ULL, 0xDA3243650005EECFULL}, /* 5^-272 */
+    {0xD863B256369D4A40ULL, 0x90BED43E40076A82ULL}, /* 5^-271 */
+    {0x873E4F75E2224E68ULL, 0x5A7744A6E804A291ULL}, /* 5^-270 */
+    {0xA90DE3535AAAE202ULL, 0x711515D0A205CB36ULL}, /* 5^-269 */
+    {0xD3515C2831559A83ULL, 0x0D5A5B44CA873E03ULL}, /* 5^-268 */
+    {0x8412D9991ED58091ULL, 0xE858790AFE9486C2ULL}, /* 5^-267 */
+    {0xA5178FFF668AE0B6ULL, 0x626E974DBE39A872ULL}, /* 5^-266 */
+    {0xCE5D73FF402D98E3ULL, 0xFB0A3D212DC8128FULL}, /* 5^-265 */
+    {0x80FA687F881C7F8EULL, 0x7CE66634BC9D0B99ULL}, /* 5^-264 */
+    {0xA139029F6A239F72ULL, 0x1C1FFFC1EBC44E80ULL}, /* 5^-263 */
+    {0xC987434744AC874EULL, 0xA327FFB266B56220ULL}, /* 5^-262 */
+    {0xFBE9141915D7A922ULL, 0x4BF1FF9F0062BAA8ULL}, /* 5^-261 */
+    {0x9D71AC8FADA6C9B5ULL, 0x6F773FC3603DB4A9ULL}, /* 5^-260 */
+    {0xC4CE17B399107C22ULL, 0xCB550FB4384D21D3ULL}, /* 5^-259 */
+    {0xF6019DA07F549B2BULL, 0x7E2A53A146606A48ULL}, /* 5^-258 */
+    {0x99C102844F94E0FBULL, 0x2EDA7444CBFC426DULL}, /* 5^-257 */
+    {0xC0314325637A1939ULL, 0xFA911155FEFB5308ULL}, /* 5^-256 */
+    {0xF03D93EEBC589F88ULL, 0x793555AB7EBA27CAULL}, /* 5^-255 */
+    {0x96267C7535B763B5ULL, 0x4BC1558B2F3458DEULL}, /* 5^-254 */
+    {0xBBB01B9283253CA2ULL, 0x9EB1AAEDFB016F16ULL}, /* 5^-253 */
+    {0xEA9C227723EE8BCBULL, 0x465E15A979C1CADCULL}, /* 5^-252 */
+    {0x92A1958A7675175FULL, 0x0BFACD89EC191EC9ULL}, /* 5^-251 */
+    {0xB749FAED14125D36ULL, 0xCEF980EC671F667BULL}, /* 5^-250 */
+    {0xE51C79A85916F484ULL, 0x82B7E12780E7401AULL}, /* 5^-249 */
+    {0x8F31CC0937AE58D2ULL, 0xD1B2ECB8B0908810ULL}, /* 5^-248 */
+    {0xB2FE3F0B8599EF07ULL, 0x861FA7E6DCB4AA15ULL}, /* 5^-247 */
+    {0xDFBDCECE67006AC9ULL, 0x67A791E093E1D49AULL}, /* 5^-246 */
+    {0x8BD6A141006042BDULL, 0xE0C8BB2C5C6D24E0ULL}, /* 5^-245 */
+    {0xAECC49914078536DULL, 0x58FAE9F773886E18ULL}, /* 5^-244 */
+    {0xDA7F5BF590966848ULL, 0xAF39A475506A899EULL}, /* 5^-243 */
+    {0x888F99797A5E012DULL, 0x6D8406C952429603ULL}, /* 5^-242 */
+    {0xAAB37FD7D8F58178ULL, 0xC8E5087BA6D33B83ULL}, /* 5^-241 */
+    {0xD5605FCDCF32E1D6ULL, 0xFB1E4A9A90880A64ULL}, /* 5^-240 */
+    {0x855C3BE0A17FCD26ULL, 0x5CF2EEA09A55067FULL}, /* 5^-239 */
+    {0xA6B34AD8C9DFC06FULL, 0xF42FAA48C0EA481EULL}, /* 5^-238 */
+    {0xD0601D8EFC57B08BULL, 0xF13B94DAF124DA26ULL}, /* 5^-237 */
+    {0x823C12795DB6CE57ULL, 0x76C53D08D6B70858ULL}, /* 5^-236 */
+    {0xA2CB1717B52481EDULL, 0x54768C4B0C64CA6EULL}, /* 5^-235 */
+    {0xCB7DDCDDA26DA268ULL, 0xA9942F5DCF7DFD09ULL}, /* 5^-234 */
+    {0xFE5D54150B090B02ULL, 0xD3F93B35435D7C4CULL}, /* 5^-233 */
+    {0x9EFA548D26E5A6E1ULL, 0xC47BC5014A1A6DAFULL}, /* 5^-232 */
+    {0xC6B8E9B0709F109AULL, 0x359AB6419CA1091BULL}, /* 5^-231 */
+    {0xF867241C8CC6D4C0ULL, 0xC30163D203C94B62ULL}, /* 5^-230 */
+    {0x9B407691D7FC44F8ULL, 0x79E0DE63425DCF1DULL}, /* 5^-229 */
+    {0xC21094364DFB5636ULL, 0x985915FC12F542E4ULL}, /* 5^-228 */
+    {0xF294B943E17A2BC4ULL, 0x3E6F5B7B17B2939DULL}, /* 5^-227 */
+    {0x979CF3CA6CEC5B5AULL, 0xA705992CEECF9C42ULL}, /* 5^-226 */
+    {0xBD8430BD08277231ULL, 0x50C6FF782A838353ULL}, /* 5^-225 */
+    {0xECE53CEC4A314EBDULL, 0xA4F8BF5635246428ULL}, /* 5^-224 */
+    {0x940F4613AE5ED136ULL, 0x871B7795E136BE99ULL}, /* 5^-223 */
+    {0xB913179899F68584ULL, 0x28E2557B59846E3FULL}, /* 5^-222 */
+    {0xE757DD7EC07426E5ULL, 0x331AEADA2FE589CFULL}, /* 5^-221 */
+    {0x9096EA6F3848984FULL, 0x3FF0D2C85DEF7621ULL}, /* 5^-220 */
+    {0xB4BCA50B065ABE63ULL, 0x0FED077A756B53A9ULL}, /* 5^-219 */
+    {0xE1EBCE4DC7F16DFBULL, 0xD3E8495912C62894ULL}, /* 5^-218 */
+    {0x8D3360F09CF6E4BDULL, 0x64712DD7ABBBD95CULL}, /* 5^-217 */
+    {0xB080392CC4349DECULL, 0xBD8D794D96AACFB3ULL}, /* 5^-216 */
+    {0xDCA04777F541C567ULL, 0xECF0D7A0FC5583A0ULL}, /* 5^-215 */
+    {0x89E42CAAF9491B60ULL, 0xF41686C49DB57244ULL}, /* 5^-214 */
+    {0xAC5D37D5B79B6239ULL, 0x311C2875C522CED5ULL}, /* 5^-213 */
+    {0xD77485CB25823AC7ULL, 0x7D633293366B828BULL}, /* 5^-212 */
+    {0x86A8D39EF77164BCULL, 0xAE5DFF9C02033197ULL}, /* 5^-211 */
+    {0xA8530886B54DBDEBULL, 0xD9F57F830283FDFCULL}, /* 5^-210 */
+    {0xD267CAA862A12D66ULL, 0xD072DF63C324FD7BULL}, /* 5^-209 */
+    {0x8380DEA93DA4BC60ULL, 0x4247CB9E59F71E6DULL}, /* 5^-208 */
+    {0xA46116538D0DEB78ULL, 0x52D9BE85F074E608ULL}, /* 5^-207 */
+    {0xCD795BE870516656ULL, 0x67902E276C921F8BULL}, /* 5^-206 */
+    {0x806BD9714632DFF6ULL, 0x00BA1CD8A3DB53B6ULL}, /* 5^-205 */
+    {0xA086CFCD97BF97F3ULL, 0x80E8A40ECCD228A4ULL}, /* 5^-204 */
+    {0xC8A883C0FDAF7DF0ULL, 0x6122CD128006B2CDULL}, /* 5^-203 */
+    {0xFAD2A4B13D1B5D6CULL, 0x796B805720085F81ULL}, /* 5^-202 */
+    {0x9CC3A6EEC6311A63ULL, 0xCBE3303674053BB0ULL}, /* 5^-201 */
+    {0xC3F490AA77BD60FCULL, 0xBEDBFC4411068A9CULL}, /* 5^-200 */
+    {0xF4F1B4D515ACB93BULL, 0xEE92FB5515482D44ULL}, /* 5^-199 */
+    {0x991711052D8BF3C5ULL, 0x751BDD152D4D1C4AULL}, /* 5^-198 */
+    {0xBF5CD54678EEF0B6ULL, 0xD262D45A78A0635DULL}, /* 5^-197 */
+    {0xEF340A98172AACE4ULL, 0x86FB897116C87C34ULL}, /* 5^-196 */
+    {0x9580869F0E7AAC0EULL, 0xD45D35E6AE3D4DA0ULL}, /* 5^-195 */
+    {0xBAE0A846D2195712ULL, 0x8974836059CCA109ULL}, /* 5^-194 */
+    {0xE998D258869FACD7ULL, 0x2BD1A438703FC94BULL}, /* 5^-193 */
+    {0x91FF83775423CC06ULL, 0x7B6306A34627DDCFULL}, /* 5^-192 */
+    {0xB67F6455292CBF08ULL, 0x1A3BC84C17B1D542ULL}, /* 5^-191 */
+    {0xE41F3D6A7377EECAULL, 0x20CABA5F1D9E4A93ULL}, /* 5^-190 */
+    {0x8E938662882AF53EULL, 0x547EB47B7282EE9CULL}, /* 5^-189 */
+    {0xB23867FB2A35B28DULL, 0xE99E619A4F23AA43ULL}, /* 5^-188 */
+    {0xDEC681F9F4C31F31ULL, 0x6405FA00E2EC94D4ULL}, /* 5^-187 */
+    {0x8B3C113C38F9F37EULL, 0xDE83BC408DD3DD04ULL}, /* 5^-186 */
+    {0xAE0B158B4738705EULL, 0x9624AB50B148D445ULL}, /* 5^-185 */
+    {0xD98DDAEE19068C76ULL, 0x3BADD624DD9B0957ULL}, /* 5^-184 */
+    {0x87F8A8D4CFA417C9ULL, 0xE54CA5D70A80E5D6ULL}, /* 5^-183 */
+    {0xA9F6D30A038D1DBCULL, 0x5E9FCF4CCD211F4CULL}, /* 5^-182 */
+    {0xD47487CC8470652BULL, 0x7647C3200069671FULL}, /* 5^-181 */
+    {0x84C8D4DFD2C63F3BULL, 0x29ECD9F40041E073ULL}, /* 5^-180 */
+    {0xA5FB0A17C777CF09ULL, 0xF468107100525890ULL}, /* 5^-179 */
+    {0xCF79CC9DB955C2CCULL, 0x7182148D4066EEB4ULL}, /* 5^-178 */
+    {0x81AC1FE293D599BFULL, 0xC6F14CD848405530ULL}, /* 5^-177 */
+    {0xA21727DB38CB002FULL, 0xB8ADA00E5A506A7CULL}, /* 5^-176 */
+    {0xCA9CF1D206FDC03BULL, 0xA6D90811F0E4851CULL}, /* 5^-175 */
+    {0xFD442E4688BD304AULL, 0x908F4A166D1DA663ULL}, /* 5^-174 */
+    {0x9E4A9CEC15763E2EULL, 0x9A598E4E043287FEULL}, /* 5^-173 */
+    {0xC5DD44271AD3CDBAULL, 0x40EFF1E1853F29FDULL}, /* 5^-172 */
+    {0xF7549530E188C128ULL, 0xD12BEE59E68EF47CULL}, /* 5^-171 */
+    {0x9A94DD3E8CF578B9ULL, 0x82BB74F8301958CEULL}, /* 5^-170 */
+    {0xC13A148E3032D6E7ULL, 0xE36A52363C1FAF01ULL}, /* 5^-169 */
+    {0xF18899B1BC3F8CA1ULL, 0xDC44E6C3CB279AC1ULL}, /* 5^-168 */
+    {0x96F5600F15A7B7E5ULL, 0x29AB103A5EF8C0B9ULL}, /* 5^-167 */
+    {0xBCB2B812DB11A5DEULL, 0x7415D448F6B6F0E7ULL}, /* 5^-166 */
+    {0xEBDF661791D60F56ULL, 0x111B495B3464AD21ULL}, /* 5^-165 */
+    {0x936B9FCEBB25C995ULL, 0xCAB10DD900BEEC34ULL}, /* 5^-164 */
+    {0xB84687C269EF3BFBULL, 0x3D5D514F40EEA742ULL}, /* 5^-163 */
+    {0xE65829B3046B0AFAULL, 0x0CB4A5A3112A5112ULL}, /* 5^-162 */
+    {0x8FF71A0FE2C2E6DCULL, 0x47F0E785EABA72ABULL}, /* 5^-161 */
+    {0xB3F4E093DB73A093ULL, 0x59ED216765690F56ULL}, /* 5^-160 */
+    {0xE0F218B8D25088B8ULL, 0x306869C13EC3532CULL}, /* 5^-159 */
+    {0x8C974F7383725573ULL, 0x1E414218C73A13FBULL}, /* 5^-158 */
+    {0xAFBD2350644EEACFULL, 0xE5D1929EF90898FAULL}, /* 5^-157 */
+    {0xDBAC6C247D62A583ULL, 0xDF45F746B74ABF39ULL}, /* 5^-156 */
+    {0x894BC396CE5DA772ULL, 0x6B8BBA8C328EB783ULL}, /* 5^-155 */
+    {0xAB9EB47C81F5114FULL, 0x066EA92F3F326564ULL}, /* 5^-154 */
+    {0xD686619BA27255A2ULL, 0xC80A537B0EFEFEBDULL}, /* 5^-153 */
+    {0x8613FD0145877585ULL, 0xBD06742CE95F5F36ULL}, /* 5^-152 */
+    {0xA798FC4196E952E7ULL, 0x2C48113823B73704ULL}, /* 5^-151 */
+    {0xD17F3B51FCA3A7A0ULL, 0xF75A15862CA504C5ULL}, /* 5^-150 */
+    {0x82EF85133DE648C4ULL, 0x9A984D73DBE722FBULL}, /* 5^-149 */
+    {0xA3AB66580D5FDAF5ULL, 0xC13E60D0D2E0EBBAULL}, /* 5^-148 */
+    {0xCC963FEE10B7D1B3ULL, 0x318DF905079926A8ULL}, /* 5^-147 */
+    {0xFFBBCFE994E5C61FULL, 0xFDF17746497F7052ULL}, /* 5^-146 */
+    {0x9FD561F1FD0F9BD3ULL, 0xFEB6EA8BEDEFA633ULL}, /* 5^-145 */
+    {0xC7CABA6E7C5382C8ULL, 0xFE64A52EE96B8FC0ULL}, /* 5^-144 */
+    {0xF9BD690A1B68637BULL, 0x3DFDCE7AA3C673B0ULL}, /* 5^-143 */
+    {0x9C1661A651213E2DULL, 0x06BEA10CA65C084EULL}, /* 5^-142 */
+    {0xC31BFA0FE5698DB8ULL, 0x486E494FCFF30A62ULL}, /* 5^-141 */
+    {0xF3E2F893DEC3F126ULL, 0x5A89DBA3C3EFCCFAULL}, /* 5^-140 */
+    {0x986DDB5C6B3A76B7ULL, 0xF89629465A75E01CULL}, /* 5^-139 */
+    {0xBE89523386091465ULL, 0xF6BBB397F1135823ULL}, /* 5^-138 */
+    {0xEE2BA6C0678B597FULL, 0x746AA07DED582E2CULL}, /* 5^-137 */
+    {0x94DB483840B717EFULL, 0xA8C2A44EB4571CDCULL}, /* 5^-136 */
+    {0xBA121A4650E4DDEBULL, 0x92F34D62616CE413ULL}, /* 5^-135 */
+    {0xE896A0D7E51E1566ULL, 0x77B020BAF9C81D17ULL}, /* 5^-134 */
+    {0x915E2486EF32CD60ULL, 0x0ACE1474DC1D122EULL}, /* 5^-133 */
+    {0xB5B5ADA8AAFF80B8ULL, 0x0D819992132456BAULL}, /* 5^-132 */
+    {0xE3231912D5BF60E6ULL, 0x10E1FFF697ED6C69ULL}, /* 5^-131 */
+    {0x8DF5EFABC5979C8FULL, 0xCA8D3FFA1EF463C1ULL}, /* 5^-130 */
+    {0xB1736B96B6FD83B3ULL, 0xBD308FF8A6B17CB2ULL}, /* 5^-129 */
+    {0xDDD0467C64BCE4A0ULL, 0xAC7CB3F6D05DDBDEULL}, /* 5^-128 */
+    {0x8AA22C0DBEF60EE4ULL, 0x6BCDF07A423AA96BULL}, /* 5^-127 */
+    {0xAD4AB7112EB3929DULL, 0x86C16C98D2C953C6ULL}, /* 5^-126 */
+    {0xD89D64D57A607744ULL, 0xE871C7BF077BA8B7ULL}, /* 5^-125 */
+    {0x87625F056C7C4A8BULL, 0x11471CD764AD4972ULL}, /* 5^-124 */
+    {0xA93AF6C6C79B5D2DULL, 0xD598E40D3DD89BCFULL}, /* 5^-123 */
+    {0xD389B47879823479ULL, 0x4AFF1D108D4EC2C3ULL}, /* 5^-122 */
+    {0x843610CB4BF160CBULL, 0xCEDF722A585139BAULL}, /* 5^-121 */
+    {0xA54394FE1EEDB8FEULL, 0xC2974EB4EE658828ULL}, /* 5^-120 */
+    {0xCE947A3DA6A9273EULL, 0x733D226229FEEA32ULL}, /* 5^-119 */
+    {0x811CCC668829B887ULL, 0x0806357D5A3F525FULL}, /* 5^-118 */
+    {0xA163FF802A3426A8ULL, 0xCA07C2DCB0CF26F7ULL}, /* 5^-117 */
+    {0xC9BCFF6034C13052ULL, 0xFC89B393DD02F0B5ULL}, /* 5^-116 */
+    {0xFC2C3F3841F17C67ULL, 0xBBAC2078D443ACE2ULL}, /* 5^-115 */
+    {0x9D9BA7832936EDC0ULL, 0xD54B944B84AA4C0DULL}, /* 5^-114 */
+    {0xC5029163F384A931ULL, 0x0A9E795E65D4DF11ULL}, /* 5^-113 */
+    {0xF64335BCF065D37DULL, 0x4D4617B5FF4A16D5ULL}, /* 5^-112 */
+    {0x99EA0196163FA42EULL, 0x504BCED1BF8E4E45ULL}, /* 5^-111 */
+    {0xC06481FB9BCF8D39ULL, 0xE45EC2862F71E1D6ULL}, /* 5^-110 */
+    {0xF07DA27A82C37088ULL, 0x5D767327BB4E5A4CULL}, /* 5^-109 */
+    {0x964E858C91BA2655ULL, 0x3A6A07F8D510F86FULL}, /* 5^-108 */
+    {0xBBE226EFB628AFEAULL, 0x890489F70A55368BULL}, /* 5^-107 */
+    {0xEADAB0ABA3B2DBE5ULL, 0x2B45AC74CCEA842EULL}, /* 5^-106 */
+    {0x92C8AE6B464FC96FULL, 0x3B0B8BC90012929DULL}, /* 5^-105 */
+    {0xB77ADA0617E3BBCBULL, 0x09CE6EBB40173744ULL}, /* 5^-104 */
+    {0xE55990879DDCAABDULL, 0xCC420A6A101D0515ULL}, /* 5^-103 */
+    {0x8F57FA54C2A9EAB6ULL, 0x9FA946824A12232DULL}, /* 5^-102 */
+    {0xB32DF8E9F3546564ULL, 0x47939822DC96ABF9ULL}, /* 5^-101 */
+    {0xDFF9772470297EBDULL, 0x59787E2B93BC56F7ULL}, /* 5^-100 */
+    {0x8BFBEA76C619EF36ULL, 0x57EB4EDB3C55B65AULL}, /* 5^-99 */
+    {0xAEFAE51477A06B03ULL, 0xEDE622920B6B23F1ULL}, /* 5^-98 */
+    {0xDAB99E59958885C4ULL, 0xE95FAB368E45ECEDULL}, /* 5^-97 */
+    {0x88B402F7FD75539BULL, 0x11DBCB0218EBB414ULL}, /* 5^-96 */
+    {0xAAE103B5FCD2A881ULL, 0xD652BDC29F26A119ULL}, /* 5^-95 */
+    {0xD59944A37C0752A2ULL, 0x4BE76D3346F0495FULL}, /* 5^-94 */
+    {0x857FCAE62D8493A5ULL, 0x6F70A4400C562DDBULL}, /* 5^-93 */
+    {0xA6DFBD9FB8E5B88EULL, 0xCB4CCD500F6BB952ULL}, /* 5^-92 */
+    {0xD097AD07A71F26B2ULL, 0x7E2000A41346A7A7ULL}, /* 5^-91 */
+    {0x825ECC24C873782FULL, 0x8ED400668C0C28C8ULL}, /* 5^-90 */
+    {0xA2F67F2DFA90563BULL, 0x728900802F0F32FAULL}, /* 5^-89 */
+    {0xCBB41EF979346BCAULL, 0x4F2B40A03AD2FFB9ULL}, /* 5^-88 */
+    {0xFEA126B7D78186BCULL, 0xE2F610C84987BFA8ULL}, /* 5^-87 */
+    {0x9F24B832E6B0F436ULL, 0x0DD9CA7D2DF4D7C9ULL}, /* 5^-86 */
+    {0xC6EDE63FA05D3143ULL, 0x91503D1C79720DBBULL}, /* 5^-85 */
+    {0xF8A95FCF88747D94ULL, 0x75A44C6397CE912AULL}, /* 5^-84 */
+    {0x9B69DBE1B548CE7CULL, 0xC986AFBE3EE11ABAULL}, /* 5^-83 */
+    {0xC24452DA229B021BULL, 0xFBE85BADCE996168ULL}, /* 5^-82 */
+    {0xF2D56790AB41C2A2ULL, 0xFAE27299423FB9C3ULL}, /* 5^-81 */
+    {0x97C560BA6B0919A5ULL, 0xDCCD879FC967D41AULL}, /* 5^-80 */
+    {0xBDB6B8E905CB600FULL, 0x5400E987BBC1C920ULL}, /* 5^-79 */
+    {0xED246723473E3813ULL, 0x290123E9AAB23B68ULL}, /* 5^-78 */
+    {0x9436C0760C86E30BULL, 0xF9A0B6720AAF6521ULL}, /* 5^-77 */
+    {0xB94470938FA89BCEULL, 0xF808E40E8D5B3E69ULL}, /* 5^-76 */
+    {0xE7958CB87392C2C2ULL, 0xB60B1D1230B20E04ULL}, /* 5^-75 */
+    {0x90BD77F3483BB9B9ULL, 0xB1C6F22B5E6F48C2ULL}, /* 5^-74 */
+    {0xB4ECD5F01A4AA828ULL, 0x1E38AEB6360B1AF3ULL}, /* 5^-73 */
+    {0xE2280B6C20DD5232ULL, 0x25C6DA63C38DE1B0ULL}, /* 5^-72 */
+    {0x8D590723948A535FULL, 0x579C487E5A38AD0EULL}, /* 5^-71 */
+    {0xB0AF48EC79ACE837ULL, 0x2D835A9DF0C6D851ULL}, /* 5^-70 */
+    {0xDCDB1B2798182244ULL, 0xF8E431456CF88E65ULL}, /* 5^-69 */
+    {0x8A08F0F8BF0F156BULL, 0x1B8E9ECB641B58FFULL}, /* 5^-68 */
+    {0xAC8B2D36EED2DAC5ULL, 0xE272467E3D222F3FULL}, /* 5^-67 */
+    {0xD7ADF884AA879177ULL, 0x5B0ED81DCC6ABB0FULL}, /* 5^-66 */
+    {0x86CCBB52EA94BAEAULL, 0x98E947129FC2B4E9ULL}, /* 5^-65 */
+    {0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL}, /* 5^-64 */
+    {0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL}, /* 5^-63 */
+    {0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL}, /* 5^-62 */
+    {0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL}, /* 5^-61 */
+    {0xCDB02555653131B6ULL, 0x3792F412CB06794DULL}, /* 5^-60 */
+    {0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL}, /* 5^-59 */
+    {0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL}, /* 5^-58 */
+    {0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL}, /* 5^-57 */
+    {0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL}, /* 5^-56 */
+    {0x9CED737BB6C4183DULL, 0x55464DD69685606BULL}, /* 5^-55 */
+    {0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL}, /* 5^-54 */
+    {0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL}, /* 5^-53 */
+    {0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL}, /* 5^-52 */
+    {0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL}, /* 5^-51 */
+    {0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL}, /* 5^-50 */
+    {0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL}, /* 5^-49 */
+    {0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL}, /* 5^-48 */
+    {0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL}, /* 5^-47 */
+    {0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL}, /* 5^-46 */
+    {0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL}, /* 5^-45 */
+    {0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL}, /* 5^-44 */
+    {0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL}, /* 5^-43 */
+    {0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL}, /* 5^-42 */
+    {0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL}, /* 5^-41 */
+    {0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL}, /* 5^-40 */
+    {0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL}, /* 5^-39 */
+    {0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL}, /* 5^-38 */
+    {0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL}, /* 5^-37 */
+    {0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL}, /* 5^-36 */
+    {0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL}, /* 5^-35 */
+    {0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL}, /* 5^-34 */
+    {0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL}, /* 5^-33 */
+    {0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL}, /* 5^-32 */
+    {0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL}, /* 5^-31 */
+    {0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL}, /* 5^-30 */
+    {0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL}, /* 5^-29 */
+    {0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL}, /* 5^-28 */
+    {0x9E74D1B791E07E48ULL, 0x775EA264CF55347EULL}, /* 5^-27 */
+    {0xC612062576589DDAULL, 0x95364AFE032A819EULL}, /* 5^-26 */
+    {0xF79687AED3EEC551ULL, 0x3A83DDBD83F52205ULL}, /* 5^-25 */
+    {0x9ABE14CD44753B52ULL, 0xC4926A9672793543ULL}, /* 5^-24 */
+    {0xC16D9A0095928A27ULL, 0x75B7053C0F178294ULL}, /* 5^-23 */
+    {0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6339ULL}, /* 5^-22 */
+    {0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E04ULL}, /* 5^-21 */
+    {0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF585ULL}, /* 5^-20 */
+    {0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E6ULL}, /* 5^-19 */
+    {0x9392EE8E921D5D07ULL, 0x3AFF322E62439FD0ULL}, /* 5^-18 */
+    {0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C3ULL}, /* 5^-17 */
+    {0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B4ULL}, /* 5^-16 */
+    {0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A11ULL}, /* 5^-15 */
+    {0xB424DC35095CD80FULL, 0x538484C19EF38C95ULL}, /* 5^-14 */
+    {0xE12E13424BB40E13ULL, 0x2865A5F206B06FBAULL}, /* 5^-13 */
+    {0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D4ULL}, /* 5^-12 */
+    {0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D749ULL}, /* 5^-11 */
+    {0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1CULL}, /* 5^-10 */
+    {0x89705F4136B4A597ULL, 0x31680A88F8953031ULL}, /* 5^-9 */
+    {0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3EULL}, /* 5^-8 */
+    {0xD6BF94D5E57A42BCULL, 0x3D32907604691B4DULL}, /* 5^-7 */
+    {0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B110ULL}, /* 5^-6 */
+    {0xA7C5AC471B478423ULL, 0x0FCF80DC33721D54ULL}, /* 5^-5 */
+    {0xD1B71758E219652BULL, 0xD3C36113404EA4A9ULL}, /* 5^-4 */
+    {0x83126E978D4FDF3BULL, 0x645A1CAC083126EAULL}, /* 5^-3 */
+    {0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A4ULL}, /* 5^-2 */
+    {0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCDULL}, /* 5^-1 */
+    {0x8000000000000000ULL, 0x0000000000000000ULL}, /* 5^0 */
+    {0xA000000000000000ULL, 0x0000000000000000ULL}, /* 5^1 */
+    {0xC800000000000000ULL, 0x0000000000000000ULL}, /* 5^2 */
+    {0xFA00000000000000ULL, 0x0000000000000000ULL}, /* 5^3 */
+    {0x9C40000000000000ULL, 0x0000000000000000ULL}, /* 5^4 */
+    {0xC350000000000000ULL, 0x0000000000000000ULL}, /* 5^5 */
+    {0xF424000000000000ULL, 0x0000000000000000ULL}, /* 5^6 */
+    {0x9896800000000000ULL, 0x0000000000000000ULL}, /* 5^7 */
+    {0xBEBC200000000000ULL, 0x0000000000000000ULL}, /* 5^8 */
+    {0xEE6B280000000000ULL, 0x0000000000000000ULL}, /* 5^9 */
+    {0x9502F90000000000ULL, 0x0000000000000000ULL}, /* 5^10 */
+    {0xBA43B74000000000ULL, 0x0000000000000000ULL}, /* 5^11 */
+    {0xE8D4A51000000000ULL, 0x0000000000000000ULL}, /* 5^12 */
+    {0x9184E72A00000000ULL, 0x0000000000000000ULL}, /* 5^13 */
+    {0xB5E620F480000000ULL, 0x0000000000000000ULL}, /* 5^14 */
+    {0xE35FA931A0000000ULL, 0x0000000000000000ULL}, /* 5^15 */
+    {0x8E1BC9BF04000000ULL, 0x0000000000000000ULL}, /* 5^16 */
+    {0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL}, /* 5^17 */
+    {0xDE0B6B3A76400000ULL, 0x0000000000000000ULL}, /* 5^18 */
+    {0x8AC7230489E80000ULL, 0x0000000000000000ULL}, /* 5^19 */
+    {0xAD78EBC5AC620000ULL, 0x0000000000000000ULL}, /* 5^20 */
+    {0xD8D726B7177A8000ULL, 0x0000000000000000ULL}, /* 5^21 */
+    {0x878678326EAC9000ULL, 0x0000000000000000ULL}, /* 5^22 */
+    {0xA968163F0A57B400ULL, 0x0000000000000000ULL}, /* 5^23 */
+    {0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL}, /* 5^24 */
+    {0x84595161401484A0ULL, 0x0000000000000000ULL}, /* 5^25 */
+    {0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL}, /* 5^26 */
+    {0xCECB8F27F4200F3AULL, 0x0000000000000000ULL}, /* 5^27 */
+    {0x813F3978F8940984ULL, 0x4000000000000000ULL}, /* 5^28 */
+    {0xA18F07D736B90BE5ULL, 0x5000000000000000ULL}, /* 5^29 */
+    {0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL}, /* 5^30 */
+    {0xFC6F7C4045812296ULL, 0x4D00000000000000ULL}, /* 5^31 */
+    {0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL}, /* 5^32 */
+    {0xC5371912364CE305ULL, 0x6C28000000000000ULL}, /* 5^33 */
+    {0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL}, /* 5^34 */
+    {0x9A130B963A6C115CULL, 0x3C7F400000000000ULL}, /* 5^35 */
+    {0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL}, /* 5^36 */
+    {0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL}, /* 5^37 */
+    {0x96769950B50D88F4ULL, 0x1314448000000000ULL}, /* 5^38 */
+    {0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL}, /* 5^39 */
+    {0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL}, /* 5^40 */
+    {0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL}, /* 5^41 */
+    {0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL}, /* 5^42 */
+    {0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL}, /* 5^43 */
+    {0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL}, /* 5^44 */
+    {0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL}, /* 5^45 */
+    {0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL}, /* 5^46 */
+    {0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL}, /* 5^47 */
+    {0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL}, /* 5^48 */
+    {0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL}, /* 5^49 */
+    {0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL}, /* 5^50 */
+    {0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL}, /* 5^51 */
+    {0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL}, /* 5^52 */
+    {0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL}, /* 5^53 */
+    {0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL}, /* 5^54 */
+    {0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL}, /* 5^55 */
+    {0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL}, /* 5^56 */
+    {0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL}, /* 5^57 */
+    {0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL}, /* 5^58 */
+    {0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL}, /* 5^59 */
+    {0x9F4F2726179A2245ULL, 0x01D762422C946590ULL}, /* 5^60 */
+    {0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL}, /* 5^61 */
+    {0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL}, /* 5^62 */
+    {0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL}, /* 5^63 */
+    {0xC2781F49FFCFA6D5ULL, 0x3CBF6B71C76B25FBULL}, /* 5^64 */
+    {0xF316271C7FC3908AULL, 0x8BEF464E3945EF7AULL}, /* 5^65 */
+    {0x97EDD871CFDA3A56ULL, 0x97758BF0E3CBB5ACULL}, /* 5^66 */
+    {0xBDE94E8E43D0C8ECULL, 0x3D52EEED1CBEA317ULL}, /* 5^67 */
+    {0xED63A231D4C4FB27ULL, 0x4CA7AAA863EE4BDDULL}, /* 5^68 */
+    {0x945E455F24FB1CF8ULL, 0x8FE8CAA93E74EF6AULL}, /* 5^69 */
+    {0xB975D6B6EE39E436ULL, 0xB3E2FD538E122B44ULL}, /* 5^70 */
+    {0xE7D34C64A9C85D44ULL, 0x60DBBCA87196B616ULL}, /* 5^71 */
+    {0x90E40FBEEA1D3A4AULL, 0xBC8955E946FE31CDULL}, /* 5^72 */
+    {0xB51D13AEA4A488DDULL, 0x6BABAB6398BDBE41ULL}, /* 5^73 */
+    {0xE264589A4DCDAB14ULL, 0xC696963C7EED2DD1ULL}, /* 5^74 */
+    {0x8D7EB76070A08AECULL, 0xFC1E1DE5CF543CA2ULL}, /* 5^75 */
+    {0xB0DE65388CC8ADA8ULL, 0x3B25A55F43294BCBULL}, /* 5^76 */
+    {0xDD15FE86AFFAD912ULL, 0x49EF0EB713F39EBEULL}, /* 5^77 */
+    {0x8A2DBF142DFCC7ABULL, 0x6E3569326C784337ULL}, /* 5^78 */
+    {0xACB92ED9397BF996ULL, 0x49C2C37F07965404ULL}, /* 5^79 */
+    {0xD7E77A8F87DAF7FBULL, 0xDC33745EC97BE906ULL}, /* 5^80 */
+    {0x86F0AC99B4E8DAFDULL, 0x69A028BB3DED71A3ULL}, /* 5^81 */
+    {0xA8ACD7C0222311BCULL, 0xC40832EA0D68CE0CULL}, /* 5^82 */
+    {0xD2D80DB02AABD62BULL, 0xF50A3FA490C30190ULL}, /* 5^83 */
+    {0x83C7088E1AAB65DBULL, 0x792667C6DA79E0FAULL}, /* 5^84 */
+    {0xA4B8CAB1A1563F52ULL, 0x577001B891185938ULL}, /* 5^85 */
+    {0xCDE6FD5E09ABCF26ULL, 0xED4C0226B55E6F86ULL}, /* 5^86 */
+    {0x80B05E5AC60B6178ULL, 0x544F8158315B05B4ULL}, /* 5^87 */
+    {0xA0DC75F1778E39D6ULL, 0x696361AE3DB1C721ULL}, /* 5^88 */
+    {0xC913936DD571C84CULL, 0x03BC3A19CD1E38E9ULL}, /* 5^89 */
+    {0xFB5878494ACE3A5FULL, 0x04AB48A04065C723ULL}, /* 5^90 */
+    {0x9D174B2DCEC0E47BULL, 0x62EB0D64283F9C76ULL}, /* 5^91 */
+    {0xC45D1DF942711D9AULL, 0x3BA5D0BD324F8394ULL}, /* 5^92 */
+    {0xF5746577930D6500ULL, 0xCA8F44EC7EE36479ULL}, /* 5^93 */
+    {0x9968BF6ABBE85F20ULL, 0x7E998B13CF4E1ECBULL}, /* 5^94 */
+    {0xBFC2EF456AE276E8ULL, 0x9E3FEDD8C321A67EULL}, /* 5^95 */
+    {0xEFB3AB16C59B14A2ULL, 0xC5CFE94EF3EA101EULL}, /* 5^96 */
+    {0x95D04AEE3B80ECE5ULL, 0xBBA1F1D158724A12ULL}, /* 5^97 */
+    {0xBB445DA9CA61281FULL, 0x2A8A6E45AE8EDC97ULL}, /* 5^98 */
+    {0xEA1575143CF97226ULL, 0xF52D09D71A3293BDULL}, /* 5^99 */
+    {0x924D692CA61BE758ULL, 0x593C2626705F9C56ULL}, /* 5^100 */
+    {0xB6E0C377CFA2E12EULL, 0x6F8B2FB00C77836CULL}, /* 5^101 */
+    {0xE498F455C38B997AULL, 0x0B6DFB9C0F956447ULL}, /* 5^102 */
+    {0x8EDF98B59A373FECULL, 0x4724BD4189BD5EACULL}, /* 5^103 */
+    {0xB2977EE300C50FE7ULL, 0x58EDEC91EC2CB657ULL}, /* 5^104 */
+    {0xDF3D5E9BC0F653E1ULL, 0x2F2967B66737E3EDULL}, /* 5^105 */
+    {0x8B865B215899F46CULL, 0xBD79E0D20082EE74ULL}, /* 5^106 */
+    {0xAE67F1E9AEC07187ULL, 0xECD8590680A3AA11ULL}, /* 5^107 */
+    {0xDA01EE641A708DE9ULL, 0xE80E6F4820CC9495ULL}, /* 5^108 */
+    {0x884134FE908658B2ULL, 0x3109058D147FDCDDULL}, /* 5^109 */
+    {0xAA51823E34A7EEDEULL, 0xBD4B46F0599FD415ULL}, /* 5^110 */
+    {0xD4E5E2CDC1D1EA96ULL, 0x6C9E18AC7007C91AULL}, /* 5^111 */
+    {0x850FADC09923329EULL, 0x03E2CF6BC604DDB0ULL}, /* 5^112 */
+    {0xA6539930BF6BFF45ULL, 0x84DB8346B786151CULL}, /* 5^113 */
+    {0xCFE87F7CEF46FF16ULL, 0xE612641865679A63ULL}, /* 5^114 */
+    {0x81F14FAE158C5F6EULL, 0x4FCB7E8F3F60C07EULL}, /* 5^115 */
+    {0xA26DA3999AEF7749ULL, 0xE3BE5E330F38F09DULL}, /* 5^116 */
+    {0xCB090C8001AB551CULL, 0x5CADF5BFD3072CC5ULL}, /* 5^117 */
+    {0xFDCB4FA002162A63ULL, 0x73D9732FC7C8F7F6ULL}, /* 5^118 */
+    {0x9E9F11C4014DDA7EULL, 0x2867E7FDDCDD9AFAULL}, /* 5^119 */
+    {0xC646D63501A1511DULL, 0xB281E1FD541501B8ULL}, /* 5^120 */
+    {0xF7D88BC24209A565ULL, 0x1F225A7CA91A4226ULL}, /* 5^121 */
+    {0x9AE757596946075FULL, 0x3375788DE9B06958ULL}, /* 5^122 */
+    {0xC1A12D2FC3978937ULL, 0x0052D6B1641C83AEULL}, /* 5^123 */
+    {0xF209787BB47D6B84ULL, 0xC0678C5DBD23A49AULL}, /* 5^124 */
+    {0x9745EB4D50CE6332ULL, 0xF840B7BA963646E0ULL}, /* 5^125 */
+    {0xBD176620A501FBFFULL, 0xB650E5A93BC3D898ULL}, /* 5^126 */
+    {0xEC5D3FA8CE427AFFULL, 0xA3E51F138AB4CEBEULL}, /* 5^127 */
+    {0x93BA47C980E98CDFULL, 0xC66F336C36B10137ULL}, /* 5^128 */
+    {0xB8A8D9BBE123F017ULL, 0xB80B0047445D4184ULL}, /* 5^129 */
+    {0xE6D3102AD96CEC1DULL, 0xA60DC059157491E5ULL}, /* 5^130 */
+    {0x9043EA1AC7E41392ULL, 0x87C89837AD68DB2FULL}, /* 5^131 */
+    {0xB454E4A179DD1877ULL, 0x29BABE4598C311FBULL}, /* 5^132 */
+    {0xE16A1DC9D8545E94ULL, 0xF4296DD6FEF3D67AULL}, /* 5^133 */
+    {0x8CE2529E2734BB1DULL, 0x1899E4A65F58660CULL}, /* 5^134 */
+    {0xB01AE745B101E9E4ULL, 0x5EC05DCFF72E7F8FULL}, /* 5^135 */
+    {0xDC21A1171D42645DULL, 0x76707543F4FA1F73ULL}, /* 5^136 */
+    {0x899504AE72497EBAULL, 0x6A06494A791C53A8ULL}, /* 5^137 */
+    {0xABFA45DA0EDBDE69ULL, 0x0487DB9D17636892ULL}, /* 5^138 */
+    {0xD6F8D7509292D603ULL, 0x45A9D2845D3C42B6ULL}, /* 5^139 */
+    {0x865B86925B9BC5C2ULL, 0x0B8A2392BA45A9B2ULL}, /* 5^140 */
+    {0xA7F26836F282B732ULL, 0x8E6CAC7768D7141EULL}, /* 5^141 */
+    {0xD1EF0244AF2364FFULL, 0x3207D795430CD926ULL}, /* 5^142 */
+    {0x8335616AED761F1FULL, 0x7F44E6BD49E807B8ULL}, /* 5^143 */
+    {0xA402B9C5A8D3A6E7ULL, 0x5F16206C9C6209A6ULL}, /* 5^144 */
+    {0xCD036837130890A1ULL, 0x36DBA887C37A8C0FULL}, /* 5^145 */
+    {0x802221226BE55A64ULL, 0xC2494954DA2C9789ULL}, /* 5^146 */
+    {0xA02AA96B06DEB0FDULL, 0xF2DB9BAA10B7BD6CULL}, /* 5^147 */
+    {0xC83553C5C8965D3DULL, 0x6F92829494E5ACC7ULL}, /* 5^148 */
+    {0xFA42A8B73ABBF48CULL, 0xCB772339BA1F17F9ULL}, /* 5^149 */
+    {0x9C69A97284B578D7ULL, 0xFF2A760414536EFBULL}, /* 5^150 */
+    {0xC38413CF25E2D70DULL, 0xFEF5138519684ABAULL}, /* 5^151 */
+    {0xF46518C2EF5B8CD1ULL, 0x7EB258665FC25D69ULL}, /* 5^152 */
+    {0x98BF2F79D5993802ULL, 0xEF2F773FFBD97A61ULL}, /* 5^153 */
+    {0xBEEEFB584AFF8603ULL, 0xAAFB550FFACFD8FAULL}, /* 5^154 */
+    {0xEEAABA2E5DBF6784ULL, 0x95BA2A53F983CF38ULL}, /* 5^155 */
+    {0x952AB45CFA97A0B2ULL, 0xDD945A747BF26183ULL}, /* 5^156 */
+    {0xBA756174393D88DFULL, 0x94F971119AEEF9E4ULL}, /* 5^157 */
+    {0xE912B9D1478CEB17ULL, 0x7A37CD5601AAB85DULL}, /* 5^158 */
+    {0x91ABB422CCB812EEULL, 0xAC62E055C10AB33AULL}, /* 5^159 */
+    {0xB616A12B7FE617AAULL, 0x577B986B314D6009ULL}, /* 5^160 */
+    {0xE39C49765FDF9D94ULL, 0xED5A7E85FDA0B80BULL}, /* 5^161 */
+    {0x8E41ADE9FBEBC27DULL, 0x14588F13BE847307ULL}, /* 5^162 */
+    {0xB1D219647AE6B31CULL, 0x596EB2D8AE258FC8ULL}, /* 5^163 */
+    {0xDE469FBD99A05FE3ULL, 0x6FCA5F8ED9AEF3BBULL}, /* 5^164 */
+    {0x8AEC23D680043BEEULL, 0x25DE7BB9480D5854ULL}, /* 5^165 */
+    {0xADA72CCC20054AE9ULL, 0xAF561AA79A10AE6AULL}, /* 5^166 */
+    {0xD910F7FF28069DA4ULL, 0x1B2BA1518094DA04ULL}, /* 5^167 */
+    {0x87AA9AFF79042286ULL, 0x90FB44D2F05D0842ULL}, /* 5^168 */
+    {0xA99541BF57452B28ULL, 0x353A1607AC744A53ULL}, /* 5^169 */
+    {0xD3FA922F2D1675F2ULL, 0x42889B8997915CE8ULL}, /* 5^170 */
+    {0x847C9B5D7C2E09B7ULL, 0x69956135FEBADA11ULL}, /* 5^171 */
+    {0xA59BC234DB398C25ULL, 0x43FAB9837E699095ULL}, /* 5^172 */
+    {0xCF02B2C21207EF2EULL, 0x94F967E45E03F4BBULL}, /* 5^173 */
+    {0x8161AFB94B44F57DULL, 0x1D1BE0EEBAC278F5ULL}, /* 5^174 */
+    {0xA1BA1BA79E1632DCULL, 0x6462D92A69731732ULL}, /* 5^175 */
+    {0xCA28A291859BBF93ULL, 0x7D7B8F7503CFDCFEULL}, /* 5^176 */
+    {0xFCB2CB35E702AF78ULL, 0x5CDA735244C3D43EULL}, /* 5^177 */
+    {0x9DEFBF01B061ADABULL, 0x3A0888136AFA64A7ULL}, /* 5^178 */
+    {0xC56BAEC21C7A1916ULL, 0x088AAA1845B8FDD0ULL}, /* 5^179 */
+    {0xF6C69A72A3989F5BULL, 0x8AAD549E57273D45ULL}, /* 5^180 */
+    {0x9A3C2087A63F6399ULL, 0x36AC54E2F678864BULL}, /* 5^181 */
+    {0xC0CB28A98FCF3C7FULL, 0x84576A1BB416A7DDULL}, /* 5^182 */
+    {0xF0FDF2D3F3C30B9FULL, 0x656D44A2A11C51D5ULL}, /* 5^183 */
+    {0x969EB7C47859E743ULL, 0x9F644AE5A4B1B325ULL}, /* 5^184 */
+    {0xBC4665B596706114ULL, 0x873D5D9F0DDE1FEEULL}, /* 5^185 */
+    {0xEB57FF22FC0C7959ULL, 0xA90CB506D155A7EAULL}, /* 5^186 */
+    {0x9316FF75DD87CBD8ULL, 0x09A7F12442D588F2ULL}, /* 5^187 */
+    {0xB7DCBF5354E9BECEULL, 0x0C11ED6D538AEB2FULL}, /* 5^188 */
+    {0xE5D3EF282A242E81ULL, 0x8F1668C8A86DA5FAULL}, /* 5^189 */
+    {0x8FA475791A569D10ULL, 0xF96E017D694487BCULL}, /* 5^190 */
+    {0xB38D92D760EC4455ULL, 0x37C981DCC395A9ACULL}, /* 5^191 */
+    {0xE070F78D3927556AULL, 0x85BBE253F47B1417ULL}, /* 5^192 */
+    {0x8C469AB843B89562ULL, 0x93956D7478CCEC8EULL}, /* 5^193 */
+    {0xAF58416654A6BABBULL, 0x387AC8D1970027B2ULL}, /* 5^194 */
+    {0xDB2E51BFE9D0696AULL, 0x06997B05FCC0319EULL}, /* 5^195 */
+    {0x88FCF317F22241E2ULL, 0x441FECE3BDF81F03ULL}, /* 5^196 */
+    {0xAB3C2FDDEEAAD25AULL, 0xD527E81CAD7626C3ULL}, /* 5^197 */
+    {0xD60B3BD56A5586F1ULL, 0x8A71E223D8D3B074ULL}, /* 5^198 */
+    {0x85C7056562757456ULL, 0xF6872D5667844E49ULL}, /* 5^199 */
+    {0xA738C6BEBB12D16CULL, 0xB428F8AC016561DBULL}, /* 5^200 */
+    {0xD106F86E69D785C7ULL, 0xE13336D701BEBA52ULL}, /* 5^201 */
+    {0x82A45B450226B39CULL, 0xECC0024661173473ULL}, /* 5^202 */
+    {0xA34D721642B06084ULL, 0x27F002D7F95D0190ULL}, /* 5^203 */
+    {0xCC20CE9BD35C78A5ULL, 0x31EC038DF7B441F4ULL}, /* 5^204 */
+    {0xFF290242C83396CEULL, 0x7E67047175A15271ULL}, /* 5^205 */
+    {0x9F79A169BD203E41ULL, 0x0F0062C6E984D386ULL}, /* 5^206 */
+    {0xC75809C42C684DD1ULL, 0x52C07B78A3E60868ULL}, /* 5^207 */
+    {0xF92E0C3537826145ULL, 0xA7709A56CCDF8A82ULL}, /* 5^208 */
+    {0x9BBCC7A142B17CCBULL, 0x88A66076400BB691ULL}, /* 5^209 */
+    {0xC2ABF989935DDBFEULL, 0x6ACFF893D00EA435ULL}, /* 5^210 */
+    {0xF356F7EBF83552FEULL, 0x0583F6B8C4124D43ULL}, /* 5^211 */
+    {0x98165AF37B2153DEULL, 0xC3727A337A8B704AULL}, /* 5^212 */
+    {0xBE1BF1B059E9A8D6ULL, 0x744F18C0592E4C5CULL}, /* 5^213 */
+    {0xEDA2EE1C7064130CULL, 0x1162DEF06F79DF73ULL}, /* 5^214 */
+    {0x9485D4D1C63E8BE7ULL, 0x8ADDCB5645AC2BA8ULL}, /* 5^215 */
+    {0xB9A74A0637CE2EE1ULL, 0x6D953E2BD7173692ULL}, /* 5^216 */
+    {0xE8111C87C5C1BA99ULL, 0xC8FA8DB6CCDD0437ULL}, /* 5^217 */
+    {0x910AB1D4DB9914A0ULL, 0x1D9C9892400A22A2ULL}, /* 5^218 */
+    {0xB54D5E4A127F59C8ULL, 0x2503BEB6D00CAB4BULL}, /* 5^219 */
+    {0xE2A0B5DC971F303AULL, 0x2E44AE64840FD61DULL}, /* 5^220 */
+    {0x8DA471A9DE737E24ULL, 0x5CEAECFED289E5D2ULL}, /* 5^221 */
+    {0xB10D8E1456105DADULL, 0x7425A83E872C5F47ULL}, /* 5^222 */
+    {0xDD50F1996B947518ULL, 0xD12F124E28F77719ULL}, /* 5^223 */
+    {0x8A5296FFE33CC92FULL, 0x82BD6B70D99AAA6FULL}, /* 5^224 */
+    {0xACE73CBFDC0BFB7BULL, 0x636CC64D1001550BULL}, /* 5^225 */
+    {0xD8210BEFD30EFA5AULL, 0x3C47F7E05401AA4EULL}, /* 5^226 */
+    {0x8714A775E3E95C78ULL, 0x65ACFAEC34810A71ULL}, /* 5^227 */
+    {0xA8D9D1535CE3B396ULL, 0x7F1839A741A14D0DULL}, /* 5^228 */
+    {0xD31045A8341CA07CULL, 0x1EDE48111209A050ULL}, /* 5^229 */
+    {0x83EA2B892091E44DULL, 0x934AED0AAB460432ULL}, /* 5^230 */
+    {0xA4E4B66B68B65D60ULL, 0xF81DA84D5617853FULL}, /* 5^231 */
+    {0xCE1DE40642E3F4B9ULL, 0x36251260AB9D668EULL}, /* 5^232 */
+    {0x80D2AE83E9CE78F3ULL, 0xC1D72B7C6B426019ULL}, /* 5^233 */
+    {0xA1075A24E4421730ULL, 0xB24CF65B8612F81FULL}, /* 5^234 */
+    {0xC94930AE1D529CFCULL, 0xDEE033F26797B627ULL}, /* 5^235 */
+    {0xFB9B7CD9A4A7443CULL, 0x169840EF017DA3B1ULL}, /* 5^236 */
+    {0x9D412E0806E88AA5ULL, 0x8E1F289560EE864EULL}, /* 5^237 */
+    {0xC491798A08A2AD4EULL, 0xF1A6F2BAB92A27E2ULL}, /* 5^238 */
+    {0xF5B5D7EC8ACB58A2ULL, 0xAE10AF696774B1DBULL}, /* 5^239 */
+    {0x9991A6F3D6BF1765ULL, 0xACCA6DA1E0A8EF29ULL}, /* 5^240 */
+    {0xBFF610B0CC6EDD3FULL, 0x17FD090A58D32AF3ULL}, /* 5^241 */
+    {0xEFF394DCFF8A948EULL, 0xDDFC4B4CEF07F5B0ULL}, /* 5^242 */
+    {0x95F83D0A1FB69CD9ULL, 0x4ABDAF101564F98EULL}, /* 5^243 */
+    {0xBB764C4CA7A4440FULL, 0x9D6D1AD41ABE37F1ULL}, /* 5^244 */
+    {0xEA53DF5FD18D5513ULL, 0x84C86189216DC5EDULL}, /* 5^245 */
+    {0x92746B9BE2F8552CULL, 0x32FD3CF5B4E49BB4ULL}, /* 5^246 */
+    {0xB7118682DBB66A77ULL, 0x3FBC8C33221DC2A1ULL}, /* 5^247 */
+    {0xE4D5E82392A40515ULL, 0x0FABAF3FEAA5334AULL}, /* 5^248 */
+    {0x8F05B1163BA6832DULL, 0x29CB4D87F2A7400EULL}, /* 5^249 */
+    {0xB2C71D5BCA9023F8ULL, 0x743E20E9EF511012ULL}, /* 5^250 */
+    {0xDF78E4B2BD342CF6ULL, 0x914DA9246B255416ULL}, /* 5^251 */
+    {0x8BAB8EEFB6409C1AULL, 0x1AD089B6C2F7548EULL}, /* 5^252 */
+    {0xAE9672ABA3D0C320ULL, 0xA184AC2473B529B1ULL}, /* 5^253 */
+    {0xDA3C0F568CC4F3E8ULL, 0xC9E5D72D90A2741EULL}, /* 5^254 */
+    {0x8865899617FB1871ULL, 0x7E2FA67C7A658892ULL}, /* 5^255 */
+    {0xAA7EEBFB9DF9DE8DULL, 0xDDBB901B98FEEAB7ULL}, /* 5^256 */
+    {0xD51EA6FA85785631ULL, 0x552A74227F3EA565ULL}, /* 5^257 */
+    {0x8533285C936B35DEULL, 0xD53A88958F87275FULL}, /* 5^258 */
+    {0xA67FF273B8460356ULL, 0x8A892ABAF368F137ULL}, /* 5^259 */
+    {0xD01FEF10A657842CULL, 0x2D2B7569B0432D85ULL}, /* 5^260 */
+    {0x8213F56A67F6B29BULL, 0x9C3B29620E29FC73ULL}, /* 5^261 */
+    {0xA298F2C501F45F42ULL, 0x8349F3BA91B47B8FULL}, /* 5^262 */
+    {0xCB3F2F7642717713ULL, 0x241C70A936219A73ULL}, /* 5^263 */
+    {0xFE0EFB53D30DD4D7ULL, 0xED238CD383AA0110ULL}, /* 5^264 */
+    {0x9EC95D1463E8A506ULL, 0xF4363804324A40AAULL}, /* 5^265 */
+    {0xC67BB4597CE2CE48ULL, 0xB143C6053EDCD0D5ULL}, /* 5^266 */
+    {0xF81AA16FDC1B81DAULL, 0xDD94B7868E94050AULL}, /* 5^267 */
+    {0x9B10A4E5E9913128ULL, 0xCA7CF2B4191C8326ULL}, /* 5^268 */
+    {0xC1D4CE1F63F57D72ULL, 0xFD1C2F611F63A3F0ULL}, /* 5^269 */
+    {0xF24A01A73CF2DCCFULL, 0xBC633B39673C8CECULL}, /* 5^270 */
+    {0x976E41088617CA01ULL, 0xD5BE0503E085D813ULL}, /* 5^271 */
+    {0xBD49D14AA79DBC82ULL, 0x4B2D8644D8A74E18ULL}, /* 5^272 */
+    {0xEC9C459D51852BA2ULL, 0xDDF8E7D60ED1219EULL}, /* 5^273 */
+    {0x93E1AB8252F33B45ULL, 0xCABB90E5C942B503ULL}, /* 5^274 */
+    {0xB8DA1662E7B00A17ULL, 0x3D6A751F3B936243ULL}, /* 5^275 */
+    {0xE7109BFBA19C0C9DULL, 0x0CC512670A783AD4ULL}, /* 5^276 */
+    {0x906A617D450187E2ULL, 0x27FB2B80668B24C5ULL}, /* 5^277 */
+    {0xB484F9DC9641E9DAULL, 0xB1F9F660802DEDF6ULL}, /* 5^278 */
+    {0xE1A63853BBD26451ULL, 0x5E7873F8A0396973ULL}, /* 5^279 */
+    {0x8D07E33455637EB2ULL, 0xDB0B487B6423E1E8ULL}, /* 5^280 */
+    {0xB049DC016ABC5E5FULL, 0x91CE1A9A3D2CDA62ULL}, /* 5^281 */
+    {0xDC5C5301C56B75F7ULL, 0x7641A140CC7810FBULL}, /* 5^282 */
+    {0x89B9B3E11B6329BAULL, 0xA9E904C87FCB0A9DULL}, /* 5^283 */
+    {0xAC2820D9623BF429ULL, 0x546345FA9FBDCD44ULL}, /* 5^284 */
+    {0xD732290FBACAF133ULL, 0xA97C177947AD4095ULL}, /* 5^285 */
+    {0x867F59A9D4BED6C0ULL, 0x49ED8EABCCCC485DULL}, /* 5^286 */
+    {0xA81F301449EE8C70ULL, 0x5C68F256BFFF5A74ULL}, /* 5^287 */
+    {0xD226FC195C6A2F8CULL, 0x73832EEC6FFF3111ULL}, /* 5^288 */
+    {0x83585D8FD9C25DB7ULL, 0xC831FD53C5FF7EABULL}, /* 5^289 */
+    {0xA42E74F3D032F525ULL, 0xBA3E7CA8B77F5E55ULL}, /* 5^290 */
+    {0xCD3A1230C43FB26FULL, 0x28CE1BD2E55F35EBULL}, /* 5^291 */
+    {0x80444B5E7AA7CF85ULL, 0x7980D163CF5B81B3ULL}, /* 5^292 */
+    {0xA0555E361951C366ULL, 0xD7E105BCC332621FULL}, /* 5^293 */
+    {0xC86AB5C39FA63440ULL, 0x8DD9472BF3FEFAA7ULL}, /* 5^294 */
+    {0xFA856334878FC150ULL, 0xB14F98F6F0FEB951ULL}, /* 5^295 */
+    {0x9C935E00D4B9D8D2ULL, 0x6ED1BF9A569F33D3ULL}, /* 5^296 */
+    {0xC3B8358109E84F07ULL, 0x0A862F80EC4700C8ULL}, /* 5^297 */
+    {0xF4A642E14C6262C8ULL, 0xCD27BB612758C0FAULL}, /* 5^298 */
+    {0x98E7E9CCCFBD7DBDULL, 0x8038D51CB897789CULL}, /* 5^299 */
+    {0xBF21E44003ACDD2CULL, 0xE0470A63E6BD56C3ULL}, /* 5^300 */
+    {0xEEEA5D5004981478ULL, 0x1858CCFCE06CAC74ULL}, /* 5^301 */
+    {0x95527A5202DF0CCBULL, 0x0F37801E0C43EBC8ULL}, /* 5^302 */
+    {0xBAA718E68396CFFDULL, 0xD30560258F54E6BAULL}, /* 5^303 */
+    {0xE950DF20247C83FDULL, 0x47C6B82EF32A2069ULL}, /* 5^304 */
+    {0x91D28B7416CDD27EULL, 0x4CDC331D57FA5441ULL}, /* 5^305 */
+    {0xB6472E511C81471DULL, 0xE0133FE4ADF8E952ULL}, /* 5^306 */
+    {0xE3D8F9E563A198E5ULL, 0x58180FDDD97723A6ULL}, /* 5^307 */
+    {0x8E679C2F5E44FF8FULL, 0x570F09EAA7EA7648ULL}, /* 5^308 */
+};
+
+/**
+ * Eisel-Lemire algorithm. Computes the correctly rounded double nearest to
+ * mant * 10^exp10 or gives up (rarely) when the truncated power of five
+ * cannot settle the rounding direction.
+ */
+static bool jsmn_eisel_lemire(uint64_t mant, const int exp10, const bool neg,
+                              double *out)
+{
+  uint64_t xhi, xlo, yhi, ylo, retmant, retexp2, msb;
+  int clz;
+
+  if (mant == 0) {
+    *out = neg ? -0.0 : 0.0;
+    return true;
+  }
+  if (exp10 < JSMN_POW5_MIN || exp10 > JSMN_POW5_MAX)
+    return false;
+
+  /* Normalization */
+  clz = jsmn_clz64(mant);
+  mant <<= clz;
+  retexp2 = (uint64_t)(((217706 * exp10) >> 16) + 64 + 1023) - (uint64_t)clz;
+
+  /* Multiplication */
+  xhi = jsmn_mul128(mant, jsmn_pow5_128[exp10 - JSMN_POW5_MIN][0], &xlo);
+
+  /* Wider approximation */
+  if ((xhi & 0x1FF) == 0x1FF && xlo + mant < mant) {
+    uint64_t mhi = xhi, mlo;
+    yhi = jsmn_mul128(mant, jsmn_pow5_128[exp10 - JSMN_POW5_MIN][1], &ylo);
+    mlo = xlo + yhi;
+    if (mlo < xlo)
+      mhi++;
+    if ((mhi & 0x1FF) == 0x1FF && mlo + 1 == 0 && ylo + mant < mant)
+      return false;
+    xhi = mhi;
+    xlo = mlo;
+  }
+
+  /* Shifting to 54 bits */
+  msb = xhi >> 63;
+  retmant = xhi >> (msb + 9);
+  retexp2 -= 1 ^ msb;
+
+  /* Half-way ambiguity */
+  if (xlo == 0 && (xhi & 0x1FF) == 0 && (retmant & 3) == 1)
+    return false;
+
+  /* From 54 to 53 bits */
+  retmant += retmant & 1;
+  retmant >>= 1;
+  if (retmant >> 53) {
+    retmant >>= 1;
+    retexp2 += 1;
+  }
+  /* Subnormals and overflows take the slow path */
+  if (retexp2 - 1 >= 0x7FF - 1)
+    return false;
+  *out = jsmn_f64_from_bits(retexp2 << 52 | (retmant & 0x000FFFFFFFFFFFFFULL) |
+                            (uint64_t)neg << 63);
+  return true;
+}
+
+/*
+ * Arbitrary precision decimal used as the slow but always correct fallback.
+ * Value is 0.d[0]d[1]...d[nd-1] * 10^dp.
+ */
+#define JSMN_DECIMAL_DIGITS 800
+#define JSMN_DECIMAL_MAXSHIFT 60
+
+struct jsmn_decimal {
+  unsigned char d[JSMN_DECIMAL_DIGITS];
+  int nd;
+  int dp;
+  bool neg;
+  bool trunc; /* nonzero digits beyond d[nd-1] were discarded */
+};
+
+static void jsmn_decimal_trim(struct jsmn_decimal *a)
+{
+  while (a->nd > 0 && a->d[a->nd - 1] == 0)
+    a->nd--;
+  if (a->nd == 0)
+    a->dp = 0;
+}
+
+static inline void jsmn_decimal_push(struct jsmn_decimal *a, const char c)
+{
+  if (a->nd < JSMN_DECIMAL_DIGITS)
+    a->d[a->nd++] = (unsigned char)(c - '0');
+  else if (c != '0')
+    a->trunc = true;
+}
+
+static void jsmn_decimal_set(struct jsmn_decimal *a,
+                             const struct jsmn_number *num)
+{
+  const char *p;
+
+  a->nd = 0;
+  a->dp = 0;
+  a->neg = num->neg;
+  a->trunc = false;
+  for (p = num->ib; p < num->ie; p++) {
+    if (a->nd == 0 && *p == '0')
+      continue;
+    a->dp++;
+    jsmn_decimal_push(a, *p);
+  }
+  for (p = num->fb; p < num->fe; p++) {
+    if (a->nd == 0 && *p == '0') {
+      a->dp--;
+      continue;
+    }
+    jsmn_decimal_push(a, *p);
+  }
+  a->dp += num->exp;
+  jsmn_decimal_trim(a);
+}
+
+/* Binary shift left (* 2^k), k <= JSMN_DECIMAL_MAXSHIFT */
+static void jsmn_decimal_lshift(struct jsmn_decimal *a, const unsigned k)
+{
+  unsigned char tmp[JSMN_DECIMAL_DIGITS + 20];
+  int w = (int)sizeof(tmp);
+  int r, nd;
+  uint64_t n = 0;
+
+  for (r = a->nd - 1; r >= 0; r--) {
+    n += (uint64_t)a->d[r] << k;
+    tmp[--w] = (unsigned char)(n % 10);
+    n /= 10;
+  }
+  for (; n > 0; n /= 10)
+    tmp[--w] = (unsigned char)(n % 10);
+
+  nd = (int)sizeof(tmp) - w;
+  a->dp += nd - a->nd;
+  if (nd > JSMN_DECIMAL_DIGITS) {
+    for (r = JSMN_DECIMAL_DIGITS; r < nd; r++)
+      a->trunc |= (tmp[w + r] != 0);
+    nd = JSMN_DECIMAL_DIGITS;
+  }
+  (void)memcpy(a->d, tmp + w, nd);
+  a->nd = nd;
+  jsmn_decimal_trim(a);
+}
+
+/* Binary shift right (/ 2^k), k <= JSMN_DECIMAL_MAXSHIFT */
+static void jsmn_decimal_rshift(struct jsmn_decimal *a, const unsigned k)
+{
+  const uint64_t mask = ((uint64_t)1 << k) - 1;
+  uint64_t n = 0;
+  int r = 0, w = 0;
+
+  /* Pick up enough leading digits to cover the first shift */
+  for (; (n >> k) == 0; r++) {
+    if (r >= a->nd) {
+      if (n == 0) {
+        a->nd = 0;
+        return;
+      }
+      for (; (n >> k) == 0; r++)
+        n *= 10;
+      break;
+    }
+    n = n * 10 + a->d[r];
+  }
+  a->dp -= r - 1;
+
+  /* Pick up a digit, put down a digit */
+  for (; r < a->nd; r++) {
+    const uint64_t c = a->d[r];
+    a->d[w++] = (unsigned char)(n >> k);
+    n = (n & mask) * 10 + c;
+  }
+
+  /* Put down extra digits */
+  for (; n > 0; n = (n & mask) * 10) {
+    const unsigned char dig = (unsigned char)(n >> k);
+    if (w < JSMN_DECIMAL_DIGITS)
+      a->d[w++] = dig;
+    else if (dig > 0)
+      a->trunc = true;
+  }
+  a->nd = w;
+  jsmn_decimal_trim(a);
+}
+
+static void jsmn_decimal_shift(struct jsmn_decimal *a, int k)
+{
+  if (a->nd == 0)
+    return;
+  for (; k > JSMN_DECIMAL_MAXSHIFT; k -= JSMN_DECIMAL_MAXSHIFT)
+    jsmn_decimal_lshift(a, JSMN_DECIMAL_MAXSHIFT);
+  for (; k < -JSMN_DECIMAL_MAXSHIFT; k += JSMN_DECIMAL_MAXSHIFT)
+    jsmn_decimal_rshift(a, JSMN_DECIMAL_MAXSHIFT);
+  if (k > 0)
+    jsmn_decimal_lshift(a, (unsigned)k);
+  else if (k < 0)
+    jsmn_decimal_rshift(a, (unsigned)-k);
+}
+
+static bool jsmn_decimal_round_up(const struct jsmn_decimal *a, const int nd)
+{
+  if (nd < 0 || nd >= a->nd)
+    return false;
+  /* Exactly halfway: round to even unless digits were truncated */
+  if (a->d[nd] == 5 && nd + 1 == a->nd)
+    return a->trunc || (nd > 0 && (a->d[nd - 1] & 1));
+  return a->d[nd] >= 5;
+}
+
+static uint64_t jsmn_decimal_rounded_integer(const struct jsmn_decimal *a)
+{
+  uint64_t n = 0;
+  int i;
+
+  if (a->dp > 20)
+    return UINT64_MAX;
+  for (i = 0; i < a->dp && i < a->nd; i++)
+    n = n * 10 + a->d[i];
+  for (; i < a->dp; i++)
+    n *= 10;
+  if (jsmn_decimal_round_up(a, a->dp))
+    n++;
+  return n;
+}
+
+#define JSMN_F64_MANTBITS 52
+#define JSMN_F64_BIAS (-1023)
+
+/**
+ * Converts the decimal to the nearest double, returns false on overflow.
+ */
+static bool jsmn_decimal_to_f64(struct jsmn_decimal *d, double *out)
+{
+  static const int powtab[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+  const int npowtab = (int)(sizeof(powtab) / sizeof(powtab[0]));
+  uint64_t mant, bits;
+  int exp, n;
+  bool ok = true;
+
+  if (d->nd == 0 || d->dp < -330) {
+    mant = 0;
+    exp = JSMN_F64_BIAS;
+    goto out;
+  }
+  if (d->dp > 310)
+    goto overflow;
+
+  /* Scale by powers of two until in range [0.5, 1) */
+  exp = 0;
+  while (d->dp > 0) {
+    n = d->dp >= npowtab ? 27 : powtab[d->dp];
+    jsmn_decimal_shift(d, -n);
+    exp += n;
+  }
+  while (d->dp < 0 || (d->dp == 0 && d->d[0] < 5)) {
+    n = -d->dp >= npowtab ? 27 : powtab[-d->dp];
+    jsmn_decimal_shift(d, n);
+    exp -= n;
+  }
+  exp--;
+
+  /* Denormals: move the exponent up to the minimum */
+  if (exp < JSMN_F64_BIAS + 1) {
+    n = JSMN_F64_BIAS + 1 - exp;
+    jsmn_decimal_shift(d, -n);
+    exp += n;
+  }
+  if (exp - JSMN_F64_BIAS >= 0x7FF)
+    goto overflow;
+
+  /* Extract 53 bits */
+  jsmn_decimal_shift(d, 1 + JSMN_F64_MANTBITS);
+  mant = jsmn_decimal_rounded_integer(d);
+
+  /* Rounding might have added a bit */
+  if (mant == (2ULL << JSMN_F64_MANTBITS)) {
+    mant >>= 1;
+    exp++;
+    if (exp - JSMN_F64_BIAS >= 0x7FF)
+      goto overflow;
+  }
+  if (!(mant & (1ULL << JSMN_F64_MANTBITS)))
+    exp = JSMN_F64_BIAS;
+  goto out;
+
+overflow:
+  mant = 0;
+  exp = 0x7FF + JSMN_F64_BIAS;
+  ok = false;
+out:
+  bits = mant & ((1ULL << JSMN_F64_MANTBITS) - 1);
+  bits |= (uint64_t)((exp - JSMN_F64_BIAS) & 0x7FF) << JSMN_F64_MANTBITS;
+  bits |= (uint64_t)d->neg << 63;
+  *out = jsmn_f64_from_bits(bits);
+  return ok;
+}
+
+/**
+ * Converts a scanned number to the correctly rounded nearest double.
+ */
+static enum jsmnerr jsmn_number_to_f64(const struct jsmn_number *num,
+                                       double *out)
+{
+  struct jsmn_decimal d;
+  double f, fup;
+
+  if (!num->trunc && jsmn_f64_exact(num->mant, num->exp10, num->neg, out))
+    return JSMN_SUCCESS;
+  if (jsmn_eisel_lemire(num->mant, num->exp10, num->neg, &f)) {
+    /* A truncated mantissa is fine if its upper bound rounds the same */
+    if (!num->trunc ||
+        (jsmn_eisel_lemire(num->mant + 1, num->exp10, num->neg, &fup) &&
+         f == fup)) {
+      *out = f;
+      return JSMN_SUCCESS;
+    }
+  }
+  jsmn_decimal_set(&d, num);
+  return jsmn_decimal_to_f64(&d, out) ? JSMN_SUCCESS : JSMN_ERROR_RANGE;
+}
+
+/**
+ * Decodes a number token as the nearest double.
+ */
+JSMN_API enum jsmnerr jsmn_get_f64(const char *js, const jsmntok_t *tok,
+                                   double *out)
+{
+  struct jsmn_number num;
+  enum jsmnerr r;
+
+  if ((r = jsmn_token_number(js, tok, &num)) != JSMN_SUCCESS)
+    return r;
+  return jsmn_number_to_f64(&num, out);
+}
+
+#define JSMN_ARRAY_MAX_DIMS 32
+
+/**
+ * Converts all numbers of a (possibly nested) rectangular array in one pass
+ * over the token array. Rectangular numeric arrays consist only of arrays
+ * and primitives, so the leaves come in row-major order and the walk needs
+ * nothing but a remaining-elements counter per dimension.
+ */
+static enum jsmnerr jsmn_array_convert(const char *js, const jsmntok_t *tokens,
+                                       const unsigned int num_tokens,
+                                       const unsigned int idx, void *out,
+                                       const size_t outcap, size_t *count,
+                                       const bool f64)
+{
+  unsigned int dims[JSMN_ARRAY_MAX_DIMS];
+  unsigned int rem[JSMN_ARRAY_MAX_DIMS];
+  unsigned int ndims = 0;
+  unsigned int i, j;
+  size_t total = 1, k = 0;
+  int depth;
+
+  if (idx >= num_tokens || tokens[idx].type != JSMN_ARRAY)
+    return JSMN_ERROR_SHAPE;
+
+  /* The shape follows from the first element of every dimension */
+  for (i = idx; i < num_tokens && tokens[i].type == JSMN_ARRAY; i++) {
+    if (tokens[i].opaque)
+      return JSMN_ERROR_INVAL;
+    if (ndims == JSMN_ARRAY_MAX_DIMS)
+      return JSMN_ERROR_SHAPE;
+    dims[ndims++] = tokens[i].size;
+    total *= tokens[i].size;
+    /* Every element needs its own token */
+    if (total > num_tokens)
+      return JSMN_ERROR_SHAPE;
+    if (tokens[i].size == 0)
+      break;
+  }
+  *count = total;
+  if (total > outcap)
+    return JSMN_ERROR_NOMEM;
+
+  /* One-dimensional arrays: a straight run of primitive tokens */
+  if (ndims == 1) {
+    if (idx + total >= num_tokens)
+      return JSMN_ERROR_SHAPE;
+    for (j = idx + 1; k < total; j++, k++) {
+      struct jsmn_number num;
+      enum jsmnerr r;
+      if ((r = jsmn_token_number(js, &tokens[j], &num)) != JSMN_SUCCESS)
+        return tokens[j].type <= JSMN_ARRAY ? JSMN_ERROR_SHAPE : r;
+      r = f64 ? jsmn_number_to_f64(&num, (double *)out + k)
+              : jsmn_number_to_i64(&num, (int64_t *)out + k);
+      if (r != JSMN_SUCCESS)
+        return r;
+    }
+    return JSMN_SUCCESS;
+  }
+
+  rem[0] = dims[0];
+  depth = 0;
+  for (j = idx + 1; depth >= 0;) {
+    const jsmntok_t *t;
+    if (rem[depth] == 0) {
+      depth--;
+      continue;
+    }
+    rem[depth]--;
+    if (j >= num_tokens)
+      return JSMN_ERROR_SHAPE;
+    t = &tokens[j++];
+    if (t->opaque)
+      return JSMN_ERROR_INVAL;
+    if ((unsigned int)depth + 1 < ndims) {
+      if (t->type != JSMN_ARRAY || (unsigned int)t->size != dims[depth + 1])
+        return JSMN_ERROR_SHAPE;
+      depth++;
+      rem[depth] = dims[depth];
+    } else {
+      struct jsmn_number num;
+      enum jsmnerr r;
+      if ((r = jsmn_token_number(js, t, &num)) != JSMN_SUCCESS)
+        return t->type <= JSMN_ARRAY ? JSMN_ERROR_SHAPE : r;
+      r = f64 ? jsmn_number_to_f64(&num, (double *)out + k)
+              : jsmn_number_to_i64(&num, (int64_t *)out + k);
+      if (r != JSMN_SUCCESS)
+        return r;
+      k++;
+    }
+  }
+  return JSMN_SUCCESS;
+}
+
+/**
+ * Converts a rectangular array of numbers into a row-major array of doubles.
+ */
+JSMN_API enum jsmnerr jsmn_array_to_f64(const char *js,
+                                        const jsmntok_t *tokens,
+                                        const unsigned int num_tokens,
+                                        const unsigned int idx, double *out,
+                                        const size_t outcap, size_t *count)
+{
+  return jsmn_array_convert(js, tokens, num_tokens, idx, out, outcap, count,
+                            true);
+}
+
+/**
+ * Converts a rectangular array of integers into a row-major int64_t array.
+ */
+JSMN_API enum jsmnerr jsmn_array_to_i64(const char *js,
+                                        const jsmntok_t *tokens,
+                                        const unsigned int num_tokens,
+                                        const unsigned int idx, int64_t *out,
+                                        const size_t outcap, size_t *count)
+{
+  return jsmn_array_convert(js, tokens, num_tokens, idx, out, outcap, count,
+                            false);
+}
+
+/*
+ * String decoding.
+ */
+
+/**
+ * Decodes a string token to UTF-8.
+ */
+JSMN_API enum jsmnerr jsmn_unescape(const char *js, const jsmntok_t *tok,
+                                    char *out, const size_t outcap,
+                                    size_t *outlen)
+{
+  if (tok->type != JSMN_STRING)
+    return JSMN_ERROR_INVAL;
+  if (!tok->has_escapes) {
+    *outlen = tok->size;
+    if (out == NULL)
+      return JSMN_SUCCESS;
+    if ((size_t)tok->size > outcap)
+      return JSMN_ERROR_NOMEM;
+    (void)memcpy(out, js + tok->start, tok->size);
+    return JSMN_SUCCESS;
+  }
+  return jsmn_unescape_span(js + tok->start, tok->size, out, outcap, outlen);
+}
+
+/*
+ * Object lookup.
+ */
+
+/**
+ * Returns the index of the first token after the subtree rooted at
+ * tokens[i]. A key is followed by its value, a container by its children.
+ */
+static unsigned int jsmn_skip_subtree(const jsmntok_t *tokens,
+                                      const unsigned int num_tokens,
+                                      unsigned int i)
+{
+  unsigned int n = 1;
+
+  while (n != 0 && i < num_tokens) {
+    const jsmntok_t *t = &tokens[i++];
+    n--;
+    if (t->type == JSMN_OBJECT || t->type == JSMN_ARRAY)
+      n += t->size;
+    else if (t->is_key)
+      n++;
+  }
+  return i;
+}
+
+static int jsmn_object_scan(const char *js, const jsmntok_t *tokens,
+                            const unsigned int num_tokens,
+                            const unsigned int obj, const char *key,
+                            const size_t keylen)
+{
+  unsigned int i = obj + 1;
+  int k;
+
+  for (k = 0; k < tokens[obj].size && i < num_tokens; k++) {
+    if (jsmn_key_equal(js, &tokens[i], key, keylen))
+      return i + 1 < num_tokens ? (int)i + 1 : -1;
+    i = jsmn_skip_subtree(tokens, num_tokens, i);
+  }
+  return -1;
+}
+
+/**
+ * Builds the hash table of tokens[obj] in the index arena. Returns the
+ * directory entry, or -1 if there is no room left.
+ */
+static int jsmn_index_build(const char *js, const jsmntok_t *tokens,
+                            const unsigned int num_tokens,
+                            const unsigned int obj, jsmn_index *index)
+{
+  unsigned int size = 1, i, mask, off;
+  int k;
+
+  while (size < 2 * (unsigned int)tokens[obj].size)
+    size <<= 1;
+  if (index->nobjs == JSMN_INDEX_OBJECTS ||
+      size > index->nslots - index->used)
+    return -1;
+
+  off = index->used;
+  mask = size - 1;
+  for (i = 0; i < size; i++)
+    index->slots[off + i].key = -1;
+
+  i = obj + 1;
+  for (k = 0; k < tokens[obj].size && i < num_tokens; k++) {
+    const uint32_t h = jsmn_key_hash(js, &tokens[i]);
+    unsigned int s = h & mask;
+    /* Linear probing keeps duplicate keys in document order */
+    while (index->slots[off + s].key != -1)
+      s = (s + 1) & mask;
+    index->slots[off + s].hash = h;
+    index->slots[off + s].key = i;
+    i = jsmn_skip_subtree(tokens, num_tokens, i);
+  }
+
+  index->used += size;
+  index->dir[index->nobjs].obj = obj;
+  index->dir[index->nobjs].off = off;
+  index->dir[index->nobjs].mask = mask;
+  return index->nobjs++;
+}
+
+/**
+ * Sets up an empty index over a caller-owned slot arena.
+ */
+JSMN_API void jsmn_index_init(jsmn_index *index, jsmn_index_slot *slots,
+                              const unsigned int nslots)
+{
+  index->slots = slots;
+  index->nslots = nslots;
+  index->used = 0;
+  index->nobjs = 0;
+}
+
+/**
+ * Looks up a key of an object, through its hash table if it has one.
+ */
+JSMN_API int jsmn_object_get(const char *js, const jsmntok_t *tokens,
+                             const unsigned int num_tokens,
+                             const unsigned int obj, const char *key,
+                             const size_t keylen, jsmn_index *index)
+{
+  const jsmn_index_slot *slots;
+  unsigned int s, mask;
+  uint32_t h;
+  int d;
+
+  if (obj >= num_tokens || tokens[obj].type != JSMN_OBJECT)
+    return -1;
+  if (tokens[obj].opaque)
+    return JSMN_ERROR_INVAL;
+  if (index == NULL || tokens[obj].size < JSMN_INDEX_MIN_KEYS)
+    return jsmn_object_scan(js, tokens, num_tokens, obj, key, keylen);
+
+  for (d = 0; d < (int)index->nobjs; d++) {
+    if (index->dir[d].obj == obj)
+      break;
+  }
+  if (d == (int)index->nobjs &&
+      (d = jsmn_index_build(js, tokens, num_tokens, obj, index)) < 0)
+    return jsmn_object_scan(js, tokens, num_tokens, obj, key, keylen);
+
+  slots = index->slots + index->dir[d].off;
+  mask = index->dir[d].mask;
+  h = jsmn_hash(JSMN_FNV_OFFSET, key, keylen);
+  for (s = h & mask; slots[s].key != -1; s = (s + 1) & mask) {
+    const unsigned int i = slots[s].key;
+    if (slots[s].hash == h && jsmn_key_equal(js, &tokens[i], key, keylen))
+      return i + 1 < num_tokens ? (int)i + 1 : -1;
+  }
+  return -1;
+}
+
+#ifdef JSMN_SYMTAB
+/*
+ * Symbol tables.
+ */
+
+/**
+ * Sets up an empty symbol table over caller-owned storage.
+ */
+JSMN_API void jsmn_symtab_init(jsmn_symtab *symtab, jsmn_sym *slots,
+                               const unsigned int nslots, char *names,
+                               const size_t namecap)
+{
+  unsigned int i;
+
+  assert(nslots != 0 && (nslots & (nslots - 1)) == 0);
+  symtab->slots = slots;
+  symtab->nslots = nslots;
+  symtab->count = 0;
+  symtab->names = names;
+  symtab->namecap = namecap;
+  symtab->namelen = 0;
+  symtab->add = false;
+  for (i = 0; i < nslots; i++)
+    slots[i].id = JSMN_SYM_UNKNOWN;
+}
+
+/**
+ * Interns a name, returning its existing id if it is already known.
+ */
+JSMN_API int jsmn_symtab_add(jsmn_symtab *symtab, const char *name,
+                             const size_t len)
+{
+  const jsmntok_t tok = jsmn_name_token(len);
+  return jsmn_symtab_lookup(symtab, name, &tok, true);
+}
+
+/**
+ * Looks up a name without interning it.
+ */
+JSMN_API int jsmn_symtab_find(jsmn_symtab *symtab, const char *name,
+                              const size_t len)
+{
+  const jsmntok_t tok = jsmn_name_token(len);
+  return jsmn_symtab_lookup(symtab, name, &tok, false);
+}
+#endif
+
+/*
+ * Shape cache.
+ */
+
+/**
+ * Sets up an empty shape cache over caller-owned shapes.
+ */
+JSMN_API void jsmn_shape_init(jsmn_shape_cache *cache, jsmn_shape *shapes,
+                              const unsigned int nshapes)
+{
+  unsigned int i;
+
+  assert(nshapes != 0 && (nshapes & (nshapes - 1)) == 0);
+  cache->shapes = shapes;
+  cache->nshapes = nshapes;
+  cache->hits = 0;
+  cache->misses = 0;
+  for (i = 0; i < nshapes; i++) {
+    shapes[i].path = 0;
+    shapes[i].nkeys = 0;
+    shapes[i].nbytes = 0;
+  }
+}
+
+/*
+ * Path projection.
+ */
+
+/**
+ * Reads the next step of a path. Returns 1 for a step, 0 at the end of the
+ * path and -1 on a syntax error.
+ */
+static int jsmn_path_step(const char **path, const bool first, int *index,
+                          const char **name, unsigned int *len)
+{
+  const char *p = *path;
+
+  if (*p == '\0')
+    return first ? -1 : 0;
+  if (*p == '.') {
+    /* A dot is always followed by a key */
+    if (first || *++p == '[')
+      return -1;
+  } else if (*p != '[' && !first) {
+    return -1;
+  }
+
+  if (*p == '[') {
+    p++;
+    if (*p == '*') {
+      *index = JSMN_PATH_ANY;
+      p++;
+    } else {
+      unsigned long i = 0;
+      if (!jsmn_isdigit(*p))
+        return -1;
+      for (; jsmn_isdigit(*p); p++) {
+        i = i * 10 + (*p - '0');
+        if (i > INT32_MAX)
+          return -1;
+      }
+      *index = (int)i;
+    }
+    if (*p++ != ']')
+      return -1;
+  } else {
+    *name = p;
+    for (; *p != '\0' && *p != '.' && *p != '['; p++)
+      ;
+    if (p == *name)
+      return -1;
+    *len = p - *name;
+    *index = JSMN_PATH_KEY;
+  }
+  *path = p;
+  return 1;
+}
+
+static inline bool jsmn_path_edge_before(const jsmn_path_edge *a,
+                                         const jsmn_path_edge *b)
+{
+  if (a->parent != b->parent)
+    return a->parent < b->parent;
+  if (a->index != b->index)
+    return a->index < b->index;
+  return a->hash < b->hash;
+}
+
+/**
+ * Sets up an empty trie holding only the root node.
+ */
+JSMN_API void jsmn_paths_init(jsmn_paths *paths, jsmn_path_node *nodes,
+                              const unsigned int nodecap,
+                              jsmn_path_edge *edges,
+                              const unsigned int edgecap)
+{
+  assert(nodecap > 0);
+  paths->nodes = nodes;
+  paths->nodecap = nodecap;
+  paths->edges = edges;
+  paths->edgecap = edgecap;
+  paths->nedges = 0;
+  paths->nnodes = 1;
+  nodes[0].first = 0;
+  nodes[0].nkeys = 0;
+  nodes[0].nidx = 0;
+  nodes[0].terminal = false;
+  nodes[0].subs = -1;
+  nodes[0].nsubs = 0;
+}
+
+/**
+ * Adds one path to the trie and returns the node it ends at in *end.
+ */
+static enum jsmnerr jsmn_paths_add(jsmn_paths *paths, const char *path,
+                                   unsigned int *end)
+{
+  const char *p = path;
+  const char *name = NULL;
+  unsigned int node = 0, len = 0, depth = 0, j;
+  int index, r;
+
+  /* Check the syntax first so a bad path leaves the trie untouched */
+  while ((r = jsmn_path_step(&p, depth == 0, &index, &name, &len)) > 0)
+    depth++;
+  if (r < 0 || depth > JSMN_PATH_DEPTH)
+    return JSMN_ERROR_INVAL;
+
+  p = path;
+  while (jsmn_path_step(&p, p == path, &index, &name, &len) > 0) {
+    const uint32_t h =
+        index == JSMN_PATH_KEY ? jsmn_hash(JSMN_FNV_OFFSET, name, len) : 0;
+    jsmn_path_edge *e = NULL;
+
+    for (j = 0; j < paths->nedges; j++) {
+      e = &paths->edges[j];
+      if (e->parent == node && e->index == index && e->hash == h &&
+          (index != JSMN_PATH_KEY ||
+           (e->len == len && memcmp(e->name, name, len) == 0)))
+        break;
+    }
+    if (j == paths->nedges) {
+      if (paths->nedges == paths->edgecap || paths->nnodes == paths->nodecap)
+        return JSMN_ERROR_NOMEM;
+      e = &paths->edges[paths->nedges++];
+      e->hash = h;
+      e->parent = node;
+      e->child = paths->nnodes++;
+      e->index = index;
+      e->name = index == JSMN_PATH_KEY ? name : NULL;
+      e->len = index == JSMN_PATH_KEY ? len : 0;
+      paths->nodes[e->child].terminal = false;
+      paths->nodes[e->child].subs = -1;
+      paths->nodes[e->child].nsubs = 0;
+    }
+    node = e->child;
+  }
+  *end = node;
+  return JSMN_SUCCESS;
+}
+
+/**
+ * Sorts the edges of every node so the parser can binary search them.
+ */
+static void jsmn_paths_sort(jsmn_paths *paths)
+{
+  unsigned int i, j;
+
+  /* Insertion sort: tries are small and usually compiled once */
+  for (i = 1; i < paths->nedges; i++) {
+    const jsmn_path_edge e = paths->edges[i];
+    for (j = i; j > 0 && jsmn_path_edge_before(&e, &paths->edges[j - 1]); j--)
+      paths->edges[j] = paths->edges[j - 1];
+    paths->edges[j] = e;
+  }
+  for (i = 0; i < paths->nnodes; i++) {
+    paths->nodes[i].first = 0;
+    paths->nodes[i].nkeys = 0;
+    paths->nodes[i].nidx = 0;
+  }
+  for (i = paths->nedges; i-- > 0;) {
+    jsmn_path_node *node = &paths->nodes[paths->edges[i].parent];
+    node->first = i;
+    if (paths->edges[i].index == JSMN_PATH_KEY)
+      node->nkeys++;
+    else
+      node->nidx++;
+  }
+}
+
+/**
+ * Adds paths to the trie.
+ */
+JSMN_API enum jsmnerr jsmn_paths_compile(jsmn_paths *paths,
+                                         const char *const *list,
+                                         const unsigned int n)
+{
+  enum jsmnerr r = JSMN_SUCCESS;
+  unsigned int i, node;
+
+  for (i = 0; i < n && r == JSMN_SUCCESS; i++) {
+    if ((r = jsmn_paths_add(paths, list[i], &node)) == JSMN_SUCCESS)
+      paths->nodes[node].terminal = true;
+  }
+  jsmn_paths_sort(paths);
+  return r;
+}
+
+/**
+ * Sets up the projection state for a new document.
+ */
+JSMN_API void jsmn_projection_init(jsmn_projection *proj,
+                                   const jsmn_paths *paths)
+{
+  proj->paths = paths;
+  proj->all = 0;
+}
+
+/*
+ * Early exit.
+ */
+
+/**
+ * Sets up the list of required keys for a new document.
+ */
+JSMN_API void jsmn_required_init(jsmn_required *req, const char *const *keys,
+                                 const unsigned int nkeys)
+{
+  assert(nkeys <= JSMN_REQUIRED_MAX);
+  req->keys = keys;
+  req->nkeys = nkeys;
+  req->found = 0;
+  req->pending = 0;
+}
+
+/*
+ * JSON Pointer.
+ */
+
+/**
+ * Returns the index of the token following the subtree of tokens[i]. Tokens
+ * are stored in document order, so that is the first token starting at or
+ * after its end.
+ */
+static unsigned int jsmn_next_sibling(const jsmntok_t *tokens,
+                                      const unsigned int num_tokens,
+                                      const unsigned int i)
+{
+  const size_t end = tokens[i].unclosed ? (size_t)-1 : tokens[i].end;
+  unsigned int lo = i + 1, hi = num_tokens;
+
+  while (lo < hi) {
+    const unsigned int mid = lo + (hi - lo) / 2;
+    if (tokens[mid].start < end)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * Index of the lowest set bit of v (nonzero).
+ */
+static inline unsigned int jsmn_ctz64(const uint64_t v)
+{
+  return 63 - jsmn_clz64(v & (~v + 1));
+}
+
+static inline bool jsmn_pointer_key(const char *js, const jsmntok_t *key,
+                                    const jsmn_pointer *ptr,
+                                    const unsigned int d)
+{
+  return jsmn_key_equal(js, key, ptr->names + ptr->refs[d].off,
+                        ptr->refs[d].len);
+}
+
+/**
+ * Decodes a pointer into reference tokens.
+ */
+JSMN_API enum jsmnerr jsmn_pointer_compile(jsmn_pointer *ptr, const char *s,
+                                           const size_t len)
+{
+  size_t i = 0, o = 0;
+
+  ptr->n = 0;
+  if (len > 0 && s[0] != '/')
+    return JSMN_ERROR_INVAL;
+  while (i < len) {
+    const size_t off = o;
+    size_t k;
+    bool numeric;
+
+    if (ptr->n == JSMN_POINTER_MAX)
+      return JSMN_ERROR_NOMEM;
+    for (i++; i < len && s[i] != '/'; i++) {
+      char c = s[i];
+      if (c == '~') {
+        if (i + 1 == len || (s[i + 1] != '0' && s[i + 1] != '1'))
+          return JSMN_ERROR_INVAL;
+        c = s[++i] == '0' ? '~' : '/';
+      }
+      if (o == JSMN_POINTER_BYTES)
+        return JSMN_ERROR_NOMEM;
+      ptr->names[o++] = c;
+    }
+
+    /* Array indexes are digits without leading zeros */
+    numeric = o > off && o - off <= 9 &&
+              (o - off == 1 || ptr->names[off] != '0');
+    for (k = off; numeric && k < o; k++)
+      numeric = jsmn_isdigit(ptr->names[k]);
+    ptr->refs[ptr->n].index = -1;
+    if (numeric) {
+      int v = 0;
+      for (k = off; k < o; k++)
+        v = v * 10 + (ptr->names[k] - '0');
+      ptr->refs[ptr->n].index = v;
+    }
+    ptr->refs[ptr->n].off = off;
+    ptr->refs[ptr->n].len = o - off;
+    ptr->n++;
+  }
+  return JSMN_SUCCESS;
+}
+
+/**
+ * Follows a pointer from the root token.
+ */
+JSMN_API int jsmn_pointer_get(const char *js, const jsmntok_t *tokens,
+                              const unsigned int num_tokens,
+                              const jsmn_pointer *ptr)
+{
+  unsigned int i = 0, d, j;
+  int k;
+
+  if (num_tokens == 0)
+    return -1;
+  for (d = 0; d < ptr->n; d++) {
+    const jsmntok_t *t = &tokens[i];
+    if (t->opaque)
+      return -1;
+    j = i + 1;
+    if (t->type == JSMN_OBJECT) {
+      for (k = 0; k < t->size && j + 1 < num_tokens; k++) {
+        if (jsmn_pointer_key(js, &tokens[j], ptr, d))
+          break;
+        j = jsmn_next_sibling(tokens, num_tokens, j + 1);
+      }
+      if (k == t->size || j + 1 >= num_tokens)
+        return -1;
+      i = j + 1;
+    } else if (t->type == JSMN_ARRAY) {
+      if (ptr->refs[d].index < 0 || ptr->refs[d].index >= t->size)
+        return -1;
+      for (k = 0; k < ptr->refs[d].index && j < num_tokens; k++)
+        j = jsmn_next_sibling(tokens, num_tokens, j);
+      if (j >= num_tokens)
+        return -1;
+      i = j;
+    } else {
+      return -1;
+    }
+  }
+  return i;
+}
+
+/**
+ * Resolves the pointers in active, which all matched up to depth d, below
+ * tokens[i]. Recursion is bounded by JSMN_POINTER_MAX.
+ */
+static void jsmn_pointer_walk(const char *js, const jsmntok_t *tokens,
+                              const unsigned int num_tokens,
+                              const jsmn_pointer *ptrs, int *out,
+                              const unsigned int i, const unsigned int d,
+                              uint64_t active)
+{
+  const jsmntok_t *t = &tokens[i];
+  uint64_t m;
+  unsigned int j = i + 1, p;
+  int k;
+
+  for (m = active; m != 0; m &= m - 1) {
+    p = jsmn_ctz64(m);
+    if (ptrs[p].n == d) {
+      out[p] = i;
+      active &= ~((uint64_t)1 << p);
+    }
+  }
+  if (active == 0 || t->opaque ||
+      (t->type != JSMN_OBJECT && t->type != JSMN_ARRAY))
+    return;
+
+  for (k = 0; k < t->size && active != 0 && j < num_tokens; k++) {
+    uint64_t sub = 0;
+    unsigned int v = j;
+    if (t->type == JSMN_OBJECT) {
+      if (++v >= num_tokens)
+        return;
+      for (m = active; m != 0; m &= m - 1) {
+        p = jsmn_ctz64(m);
+        if (jsmn_pointer_key(js, &tokens[j], &ptrs[p], d))
+          sub |= (uint64_t)1 << p;
+      }
+    } else {
+      for (m = active; m != 0; m &= m - 1) {
+        p = jsmn_ctz64(m);
+        if (ptrs[p].refs[d].index == k)
+          sub |= (uint64_t)1 << p;
+      }
+    }
+    if (sub != 0) {
+      /* First match wins for duplicate keys */
+      active &= ~sub;
+      jsmn_pointer_walk(js, tokens, num_tokens, ptrs, out, v, d + 1, sub);
+    }
+    j = jsmn_next_sibling(tokens, num_tokens, v);
+  }
+}
+
+/**
+ * Resolves several pointers in one walk over the token array.
+ */
+JSMN_API void jsmn_pointer_get_many(const char *js, const jsmntok_t *tokens,
+                                    const unsigned int num_tokens,
+                                    const jsmn_pointer *ptrs,
+                                    const unsigned int n, int *out)
+{
+  unsigned int p;
+
+  assert(n <= 64);
+  for (p = 0; p < n; p++)
+    out[p] = -1;
+  if (n == 0 || num_tokens == 0)
+    return;
+  jsmn_pointer_walk(js, tokens, num_tokens, ptrs, out, 0, 0,
+                    n == 64 ? ~(uint64_t)0 : ((uint64_t)1 << n) - 1);
+}
+
+/*
+ * Subscriptions.
+ */
+
+/**
+ * Compares the predicate of sub with op on the n bytes at v: by op, then
+ * length, then bytes. A NULL v stands for the least value of length n.
+ */
+static int jsmn_sub_cmp(const jsmn_sub *sub, const enum jsmn_sub_op op,
+                        const char *v, const size_t n)
+{
+  if (sub->op != op)
+    return sub->op < op ? -1 : 1;
+  if (op == JSMN_SUB_EXISTS)
+    return 0;
+  if (sub->len != n)
+    return sub->len < n ? -1 : 1;
+  return v == NULL ? 0 : memcmp(sub->value, v, n);
+}
+
+static inline bool jsmn_sub_less(const jsmn_sub *subs, const int a,
+                                 const int b)
+{
+  return jsmn_sub_cmp(&subs[a], subs[b].op, subs[b].value, subs[b].len) < 0;
+}
+
+/**
+ * Heapsorts the run subs[first..first + n) of the match order, so a node
+ * with many subscriptions is not quadratic to compile.
+ */
+static void jsmn_subs_sort(jsmn_sub *subs, const unsigned int first,
+                           const unsigned int n)
+{
+  jsmn_sub *run = subs + first;
+  unsigned int i = n / 2, end = n, root, child;
+  int tmp;
+
+  while (end > 1) {
+    if (i > 0) {
+      i--;
+    } else {
+      end--;
+      tmp = run[0].order;
+      run[0].order = run[end].order;
+      run[end].order = tmp;
+    }
+    for (root = i; (child = 2 * root + 1) < end; root = child) {
+      if (child + 1 < end &&
+          jsmn_sub_less(subs, run[child].order, run[child + 1].order))
+        child++;
+      if (!jsmn_sub_less(subs, run[root].order, run[child].order))
+        break;
+      tmp = run[root].order;
+      run[root].order = run[child].order;
+      run[child].order = tmp;
+    }
+  }
+}
+
+/**
+ * Groups the subscriptions by the trie node their path ends at: a first
+ * pass counts them, a second one places them, and each run is sorted.
+ */
+JSMN_API enum jsmnerr jsmn_subs_compile(jsmn_paths *paths, jsmn_sub *subs,
+                                        const unsigned int n)
+{
+  enum jsmnerr r = JSMN_SUCCESS;
+  unsigned int i, node, at = 0;
+
+  for (i = 0; i < n && r == JSMN_SUCCESS; i++) {
+    if ((r = jsmn_paths_add(paths, subs[i].path, &node)) == JSMN_SUCCESS)
+      paths->nodes[node].nsubs++;
+  }
+  for (i = 0; i < paths->nnodes; i++) {
+    jsmn_path_node *nd = &paths->nodes[i];
+    nd->subs = nd->nsubs > 0 && r == JSMN_SUCCESS ? (int)at : -1;
+    at += r == JSMN_SUCCESS ? nd->nsubs : 0;
+    nd->nsubs = 0;
+  }
+  /* Adding the same paths again only finds their nodes */
+  for (i = 0; i < n && r == JSMN_SUCCESS; i++) {
+    jsmn_path_node *nd;
+    (void)jsmn_paths_add(paths, subs[i].path, &node);
+    nd = &paths->nodes[node];
+    subs[nd->subs + nd->nsubs++].order = i;
+  }
+  for (i = 0; i < paths->nnodes && r == JSMN_SUCCESS; i++) {
+    if (paths->nodes[i].nsubs > 1)
+      jsmn_subs_sort(subs, paths->nodes[i].subs, paths->nodes[i].nsubs);
+  }
+  jsmn_paths_sort(paths);
+  return r;
+}
+
+static bool jsmn_sub_test(const char *js, const jsmntok_t *tok,
+                          const jsmn_sub *sub)
+{
+  if (sub->op == JSMN_SUB_EXISTS)
+    return true;
+  if (tok->type == JSMN_STRING)
+    return jsmn_string_match(js, tok, sub->value, sub->len,
+                             sub->op == JSMN_SUB_PREFIX);
+  if (tok->type != JSMN_PRIMITIVE || (size_t)tok->size < sub->len)
+    return false;
+  return (sub->op == JSMN_SUB_PREFIX || (size_t)tok->size == sub->len) &&
+         memcmp(js + tok->start, sub->value, sub->len) == 0;
+}
+
+/**
+ * Returns the first slot of subs[lo..hi) of the match order whose predicate
+ * is not below op on v[0..n).
+ */
+static int jsmn_subs_lower(const jsmn_sub *subs, int lo, int hi,
+                           const enum jsmn_sub_op op, const char *v,
+                           const size_t n)
+{
+  while (lo < hi) {
+    const int mid = lo + (hi - lo) / 2;
+    if (jsmn_sub_cmp(&subs[subs[mid].order], op, v, n) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+static inline void jsmn_sub_mark(uint32_t *matched, const int s)
+{
+  matched[s / 32] |= (uint32_t)1 << (s % 32);
+}
+
+/**
+ * Marks the subscriptions of trie node nd that tok satisfies. The run is
+ * sorted by predicate, so the existence tests come first, the values to
+ * compare with are binary searched, and the prefixes are searched once per
+ * length they come in.
+ */
+static void jsmn_subs_test(const char *js, const jsmntok_t *tok,
+                           const jsmn_sub *subs, const jsmn_path_node *nd,
+                           uint32_t *matched)
+{
+  const int end = nd->subs + (int)nd->nsubs;
+  int k = nd->subs, s;
+  const char *v = js + tok->start;
+  size_t n = tok->size;
+  char buf[256];
+
+  for (; k < end && subs[subs[k].order].op == JSMN_SUB_EXISTS; k++)
+    jsmn_sub_mark(matched, subs[k].order);
+  if (k == end ||
+      (tok->type != JSMN_STRING && tok->type != JSMN_PRIMITIVE))
+    return;
+  if (tok->type == JSMN_STRING && tok->has_escapes) {
+    if (jsmn_unescape_span(v, n, buf, sizeof(buf), &n) != JSMN_SUCCESS) {
+      for (; k < end; k++) {
+        if (jsmn_sub_test(js, tok, &subs[subs[k].order]))
+          jsmn_sub_mark(matched, subs[k].order);
+      }
+      return;
+    }
+    v = buf;
+  }
+
+  for (k = jsmn_subs_lower(subs, k, end, JSMN_SUB_EQUALS, v, n);
+       k < end &&
+       jsmn_sub_cmp(&subs[subs[k].order], JSMN_SUB_EQUALS, v, n) == 0;
+       k++)
+    jsmn_sub_mark(matched, subs[k].order);
+
+  k = jsmn_subs_lower(subs, k, end, JSMN_SUB_PREFIX, NULL, 0);
+  while (k < end && subs[subs[k].order].len <= n) {
+    const size_t len = subs[subs[k].order].len;
+    for (s = jsmn_subs_lower(subs, k, end, JSMN_SUB_PREFIX, v, len);
+         s < end &&
+         jsmn_sub_cmp(&subs[subs[s].order], JSMN_SUB_PREFIX, v, len) == 0;
+         s++)
+      jsmn_sub_mark(matched, subs[s].order);
+    k = jsmn_subs_lower(subs, s, end, JSMN_SUB_PREFIX, NULL, len + 1);
+  }
+}
+
+/**
+ * Tests the subscriptions of node on tokens[i] and descends into the
+ * children the trie continues with. Recursion is bounded by
+ * JSMN_PATH_DEPTH.
+ */
+static void jsmn_subs_walk(const char *js, const jsmntok_t *tokens,
+                           const unsigned int num_tokens,
+                           const jsmn_paths *paths, const jsmn_sub *subs,
+                           uint32_t *matched, const unsigned int i,
+                           const unsigned int node)
+{
+  const jsmn_path_node *nd = &paths->nodes[node];
+  const jsmntok_t *t = &tokens[i];
+  unsigned int j = i + 1;
+  int k, child, any = -1;
+
+  if (nd->nsubs > 0)
+    jsmn_subs_test(js, t, subs, nd, matched);
+  if (t->opaque || (t->type == JSMN_OBJECT ? nd->nkeys : nd->nidx) == 0)
+    return;
+  /* [*] sorts before the indexes; unlike projection both are followed */
+  if (nd->nidx > 0 &&
+      paths->edges[nd->first + nd->nkeys].index == JSMN_PATH_ANY)
+    any = paths->edges[nd->first + nd->nkeys].child;
+
+  for (k = 0; k < t->size && j < num_tokens; k++) {
+    unsigned int v = j;
+    if (t->type == JSMN_OBJECT) {
+      if (++v >= num_tokens)
+        return;
+      child = jsmn_paths_key(paths, node, js, &tokens[j]);
+    } else if (t->type == JSMN_ARRAY) {
+      child = jsmn_paths_index(paths, node, k);
+    } else {
+      return;
+    }
+    if (child >= 0)
+      jsmn_subs_walk(js, tokens, num_tokens, paths, subs, matched, v, child);
+    if (t->type == JSMN_ARRAY && any >= 0 && child != any)
+      jsmn_subs_walk(js, tokens, num_tokens, paths, subs, matched, v, any);
+    j = jsmn_next_sibling(tokens, num_tokens, v);
+  }
+}
+
+/**
+ * Runs all subscriptions in one walk over the token array.
+ */
+JSMN_API void jsmn_subs_match(const char *js, const jsmntok_t *tokens,
+                              const unsigned int num_tokens,
+                              const jsmn_paths *paths, const jsmn_sub *subs,
+                              const unsigned int n, uint32_t *matched)
+{
+  memset(matched, 0, (n + 31) / 32 * sizeof(*matched));
+  if (n == 0 || num_tokens == 0)
+    return;
+  jsmn_subs_walk(js, tokens, num_tokens, paths, subs, matched, 0, 0);
+}
+
+/*
+ * Prefilter.
+ */
+
+/**
+ * Records the needles and their lengths.
+ */
+JSMN_API enum jsmnerr jsmn_prefilter_init(jsmn_prefilter *pf,
+                                          const char *const *needles,
+                                          const unsigned int n,
+                                          const bool any)
+{
+  unsigned int i;
+
+  pf->n = 0;
+  pf->any = any;
+  if (n > JSMN_PREFILTER_MAX)
+    return JSMN_ERROR_NOMEM;
+  for (i = 0; i < n; i++) {
+    if (needles[i][0] == '\0')
+      return JSMN_ERROR_INVAL;
+    pf->needles[i].s = needles[i];
+    pf->needles[i].len = strlen(needles[i]);
+  }
+  pf->n = n;
+  return JSMN_SUCCESS;
+}
+
+/**
+ * Finds the first byte of s[0..n) equal to c, or n.
+ */
+static size_t jsmn_find_byte(const char *s, const size_t n, const char c)
+{
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    const uint64_t m = JSMN_HASBYTE(jsmn_read64le(s + i), c);
+    if (m != 0) {
+      /* Bytes above the first match may be flagged wrongly, not below */
+      return i + jsmn_ctz64(m) / 8;
+    }
+  }
+  for (; i < n && s[i] != c; i++)
+    ;
+  return i;
+}
+
+/**
+ * Tells whether s[0..n) contains the needle. Eight candidate positions are
+ * tested at once by comparing both the first and the last byte of the
+ * needle, and only those that agree are compared in full.
+ */
+static bool jsmn_contains(const char *s, const size_t n, const char *needle,
+                          const size_t len)
+{
+  const uint64_t first = JSMN_ONES * (unsigned char)needle[0];
+  const uint64_t last = JSMN_ONES * (unsigned char)needle[len - 1];
+  size_t i = 0;
+
+  if (len > n)
+    return false;
+  for (; i + len - 1 + 8 <= n; i += 8) {
+    uint64_t m = JSMN_HASZERO((jsmn_read64le(s + i) ^ first) |
+                              (jsmn_read64le(s + i + len - 1) ^ last));
+    for (; m != 0; m &= m - 1) {
+      const size_t at = i + jsmn_ctz64(m) / 8;
+      if (memcmp(s + at, needle, len) == 0)
+        return true;
+    }
+  }
+  for (; i + len <= n; i++) {
+    if (s[i] == needle[0] && memcmp(s + i, needle, len) == 0)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * Searches the needles in turn, stopping as soon as the outcome is known.
+ */
+JSMN_API bool jsmn_prefilter_match(const jsmn_prefilter *pf, const char *js,
+                                   const size_t len)
+{
+  unsigned int i;
+
+  for (i = 0; i < pf->n; i++) {
+    if (jsmn_contains(js, len, pf->needles[i].s, pf->needles[i].len) ==
+        pf->any)
+      break;
+  }
+  /* Stopped on a hit in any mode or on a miss otherwise */
+  if ((i < pf->n) == pf->any || pf->n == 0)
+    return true;
+  return jsmn_find_byte(js, len, '\\') < len;
+}
+
+/**
+ * Splits the buffer at newlines and skips the records that cannot match.
+ */
+JSMN_API bool jsmn_prefilter_next(const jsmn_prefilter *pf, const char *buf,
+                                  const size_t len, size_t *pos,
+                                  size_t *start, size_t *end)
+{
+  while (*pos < len) {
+    const size_t s = *pos;
+    const size_t e = s + jsmn_find_byte(buf + s, len - s, '\n');
+
+    *pos = e < len ? e + 1 : e;
+    if (e > s && jsmn_prefilter_match(pf, buf + s, e - s)) {
+      *start = s;
+      *end = e;
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Output sink.
+ */
+
+JSMN_API void jsmn_sink_init(jsmn_sink *sink, char *buf, const size_t cap,
+                             int (*flush)(void *ctx, const char *data,
+                                          size_t len),
+                             void *ctx)
+{
+  sink->buf = buf;
+  sink->cap = cap;
+  sink->len = 0;
+  sink->flush = flush;
+  sink->ctx = ctx;
+}
+
+JSMN_API enum jsmnerr jsmn_sink_flush(jsmn_sink *sink)
+{
+  if (sink->flush == NULL || sink->len == 0)
+    return JSMN_SUCCESS;
+  if (sink->flush(sink->ctx, sink->buf, sink->len) != 0)
+    return JSMN_ERROR_FLUSH;
+  sink->len = 0;
+  return JSMN_SUCCESS;
+}
+
+/**
+ * Buffers small writes and passes large ones through without a copy.
+ */
+JSMN_API enum jsmnerr jsmn_sink_write(jsmn_sink *sink, const char *data,
+                                      const size_t n)
+{
+  enum jsmnerr r;
+
+  if (n <= sink->cap - sink->len) {
+    memcpy(sink->buf + sink->len, data, n);
+    sink->len += n;
+    return JSMN_SUCCESS;
+  }
+  if (sink->flush == NULL)
+    return JSMN_ERROR_NOMEM;
+  if ((r = jsmn_sink_flush(sink)) != JSMN_SUCCESS)
+    return r;
+  if (n <= sink->cap) {
+    memcpy(sink->buf, data, n);
+    sink->len = n;
+    return JSMN_SUCCESS;
+  }
+  return sink->flush(sink->ctx, data, n) != 0 ? JSMN_ERROR_FLUSH
+                                              : JSMN_SUCCESS;
+}
+
+/*
+ * Rewriting.
+ */
+
+/**
+ * Links each trie node that ends a rewrite path to its first rewrite.
+ */
+JSMN_API enum jsmnerr jsmn_rewrite_compile(jsmn_paths *paths,
+                                           const jsmn_rewrite *rules,
+                                           const unsigned int n)
+{
+  enum jsmnerr r = JSMN_SUCCESS;
+  unsigned int i, node;
+
+  for (i = 0; i < n && r == JSMN_SUCCESS; i++) {
+    if ((r = jsmn_paths_add(paths, rules[i].path, &node)) == JSMN_SUCCESS) {
+      paths->nodes[node].terminal = true;
+      if (paths->nodes[node].subs < 0)
+        paths->nodes[node].subs = i;
+    }
+  }
+  jsmn_paths_sort(paths);
+  return r;
+}
+
+/**
+ * Emits the replacements below tokens[i] in document order, copying the
+ * bytes since *last before each. Recursion is bounded by JSMN_PATH_DEPTH.
+ */
+static enum jsmnerr jsmn_rewrite_walk(const char *js, const jsmntok_t *tokens,
+                                      const unsigned int num_tokens,
+                                      const jsmn_paths *paths,
+                                      const jsmn_rewrite *rules,
+                                      jsmn_sink *out, size_t *last,
+                                      const unsigned int i,
+                                      const unsigned int node)
+{
+  const jsmn_path_node *nd = &paths->nodes[node];
+  const jsmntok_t *t = &tokens[i];
+  unsigned int j = i + 1;
+  enum jsmnerr r;
+  int k, child;
+
+  if (nd->subs >= 0) {
+    /* Strings span their contents only */
+    const size_t start = t->type == JSMN_STRING ? t->start - 1 : t->start;
+    const size_t end = t->type == JSMN_STRING ? t->end + 1 : t->end;
+    const jsmn_rewrite *rule = &rules[nd->subs];
+
+    if ((r = jsmn_sink_write(out, js + *last, start - *last)) !=
+            JSMN_SUCCESS ||
+        (r = jsmn_sink_write(out, rule->value, rule->len)) != JSMN_SUCCESS)
+      return r;
+    *last = end;
+    return JSMN_SUCCESS;
+  }
+  if (t->opaque || (t->type == JSMN_OBJECT ? nd->nkeys : nd->nidx) == 0)
+    return JSMN_SUCCESS;
+
+  for (k = 0; k < t->size && j < num_tokens; k++) {
+    unsigned int v = j;
+    if (t->type == JSMN_OBJECT) {
+      if (++v >= num_tokens)
+        break;
+      child = jsmn_paths_key(paths, node, js, &tokens[j]);
+    } else if (t->type == JSMN_ARRAY) {
+      child = jsmn_paths_index(paths, node, k);
+    } else {
+      break;
+    }
+    if (child >= 0 &&
+        (r = jsmn_rewrite_walk(js, tokens, num_tokens, paths, rules, out,
+                               last, v, child)) != JSMN_SUCCESS)
+      return r;
+    j = jsmn_next_sibling(tokens, num_tokens, v);
+  }
+  return JSMN_SUCCESS;
+}
+
+/**
+ * Copies the document around the replaced values.
+ */
+JSMN_API enum jsmnerr jsmn_rewrite_run(const char *js, const size_t len,
+                                       const jsmntok_t *tokens,
+                                       const unsigned int num_tokens,
+                                       const jsmn_paths *paths,
+                                       const jsmn_rewrite *rules,
+                                       jsmn_sink *out)
+{
+  size_t last = 0;
+  enum jsmnerr r;
+
+  if (num_tokens > 0 &&
+      (r = jsmn_rewrite_walk(js, tokens, num_tokens, paths, rules, out,
+                             &last, 0, 0)) != JSMN_SUCCESS)
+    return r;
+  return jsmn_sink_write(out, js + last, len - last);
+}
+
+/*
+ * Number formatting.
+ */
+
+static void jsmn_decimal_assign(struct jsmn_decimal *a, uint64_t v)
+{
+  unsigned char tmp[20];
+  int n = 0;
+
+  a->nd = 0;
+  a->neg = false;
+  a->trunc = false;
+  for (; v > 0; v /= 10)
+    tmp[n++] = (unsigned char)(v % 10);
+  a->dp = n;
+  while (n > 0)
+    a->d[a->nd++] = tmp[--n];
+  jsmn_decimal_trim(a);
+}
+
+static void jsmn_decimal_floor(struct jsmn_decimal *a, const int nd)
+{
+  a->nd = nd;
+  jsmn_decimal_trim(a);
+}
+
+static void jsmn_decimal_ceil(struct jsmn_decimal *a, const int nd)
+{
+  int i = nd - 1;
+
+  while (i >= 0 && a->d[i] == 9)
+    i--;
+  if (i < 0) {
+    a->d[0] = 1;
+    a->nd = 1;
+    a->dp++;
+    return;
+  }
+  a->d[i]++;
+  a->nd = i + 1;
+}
+
+/**
+ * Cuts the exact value of mant * 2^(exp - 52) in d down to the fewest
+ * digits that still read back as the same double, by comparing it with the
+ * halfway points to its neighbours.
+ */
+static void jsmn_decimal_shortest(struct jsmn_decimal *d, const uint64_t mant,
+                                  const int exp)
+{
+  const int minexp = JSMN_F64_BIAS + 1;
+  const bool inclusive = (mant & 1) == 0;
+  struct jsmn_decimal upper, lower;
+  uint64_t mantlo;
+  int explo, ui, upperdelta = 0;
+
+  if (mant == 0) {
+    d->nd = 0;
+    return;
+  }
+  /* Exactly representable integers are already as short as they get */
+  if (exp > minexp && 332 * (d->dp - d->nd) >= 100 * (exp - JSMN_F64_MANTBITS))
+    return;
+
+  jsmn_decimal_assign(&upper, mant * 2 + 1);
+  jsmn_decimal_shift(&upper, exp - JSMN_F64_MANTBITS - 1);
+  /* The gap below a power of two is half as wide */
+  if (mant > (uint64_t)1 << JSMN_F64_MANTBITS || exp == minexp) {
+    mantlo = mant - 1;
+    explo = exp;
+  } else {
+    mantlo = mant * 2 - 1;
+    explo = exp - 1;
+  }
+  jsmn_decimal_assign(&lower, mantlo * 2 + 1);
+  jsmn_decimal_shift(&lower, explo - JSMN_F64_MANTBITS - 1);
+
+  for (ui = 0;; ui++) {
+    const int mi = ui - upper.dp + d->dp;
+    const int li = ui - upper.dp + lower.dp;
+    int l = 0, m = 0, u = 0;
+    bool okdown, okup;
+
+    if (mi >= d->nd)
+      break;
+    if (li >= 0 && li < lower.nd)
+      l = lower.d[li];
+    if (mi >= 0)
+      m = d->d[mi];
+    if (ui < upper.nd)
+      u = upper.d[ui];
+
+    okdown = l != m || (inclusive && li + 1 == lower.nd);
+    if (upperdelta == 0 && m + 1 < u)
+      upperdelta = 2;
+    else if (upperdelta == 0 && m != u)
+      upperdelta = 1;
+    else if (upperdelta == 1 && (m != 9 || u != 0))
+      upperdelta = 2;
+    okup = upperdelta > 0 && (inclusive || upperdelta > 1 || ui + 1 < upper.nd);
+
+    if (okdown && okup) {
+      if (jsmn_decimal_round_up(d, mi + 1))
+        jsmn_decimal_ceil(d, mi + 1);
+      else
+        jsmn_decimal_floor(d, mi + 1);
+      return;
+    }
+    if (okdown) {
+      jsmn_decimal_floor(d, mi + 1);
+      return;
+    }
+    if (okup) {
+      jsmn_decimal_ceil(d, mi + 1);
+      return;
+    }
+  }
+}
+
+/**
+ * Formats digits d[0..k) * 10^(n - k) the way ECMAScript prints numbers:
+ * plainly for 1e-7 < |v| < 1e21 and with an exponent otherwise.
+ */
+static size_t jsmn_format_digits(char *buf, const bool neg,
+                                 const unsigned char *d, const int k,
+                                 const int n)
+{
+  char *p = buf;
+  int i, e;
+
+  if (neg)
+    *p++ = '-';
+  if (k == 0) {
+    *p++ = '0';
+  } else if (k <= n && n <= 21) {
+    for (i = 0; i < k; i++)
+      *p++ = (char)('0' + d[i]);
+    for (; i < n; i++)
+      *p++ = '0';
+  } else if (0 < n && n <= 21) {
+    for (i = 0; i < n; i++)
+      *p++ = (char)('0' + d[i]);
+    *p++ = '.';
+    for (; i < k; i++)
+      *p++ = (char)('0' + d[i]);
+  } else if (-6 < n && n <= 0) {
+    *p++ = '0';
+    *p++ = '.';
+    for (i = n; i < 0; i++)
+      *p++ = '0';
+    for (i = 0; i < k; i++)
+      *p++ = (char)('0' + d[i]);
+  } else {
+    *p++ = (char)('0' + d[0]);
+    if (k > 1) {
+      *p++ = '.';
+      for (i = 1; i < k; i++)
+        *p++ = (char)('0' + d[i]);
+    }
+    *p++ = 'e';
+    e = n - 1;
+    *p++ = e < 0 ? '-' : '+';
+    if (e < 0)
+      e = -e;
+    if (e >= 100)
+      *p++ = (char)('0' + e / 100);
+    if (e >= 10)
+      *p++ = (char)('0' + e / 10 % 10);
+    *p++ = (char)('0' + e % 10);
+  }
+  return p - buf;
+}
+
+/**
+ * 64-bit floating point number f * 2^e without rounding ("do-it-yourself
+ * floating point").
+ */
+struct jsmn_diyfp {
+  uint64_t f;
+  int e;
+};
+
+/**
+ * Product rounded to 64 bits.
+ */
+static inline struct jsmn_diyfp jsmn_diyfp_mul(const struct jsmn_diyfp a,
+                                               const struct jsmn_diyfp b)
+{
+  struct jsmn_diyfp r;
+  uint64_t lo;
+
+  r.f = jsmn_mul128(a.f, b.f, &lo);
+  r.f += lo >> 63;
+  r.e = a.e + b.e + 64;
+  return r;
+}
+
+/**
+ * Moves digit weeding towards w and checks that the result is the closest
+ * shortest representation, see Loitsch, "Printing Floating-Point Numbers
+ * Quickly and Accurately with Integers" (2010).
+ */
+static bool jsmn_grisu_weed(unsigned char *d, const int n,
+                            const uint64_t dist_high_w,
+                            const uint64_t unsafe_interval, uint64_t rest,
+                            const uint64_t ten_kappa, const uint64_t unit)
+{
+  const uint64_t small_dist = dist_high_w - unit;
+  const uint64_t big_dist = dist_high_w + unit;
+
+  while (rest < small_dist && unsafe_interval - rest >= ten_kappa &&
+         (rest + ten_kappa < small_dist ||
+          small_dist - rest >= rest + ten_kappa - small_dist)) {
+    d[n - 1]--;
+    rest += ten_kappa;
+  }
+  if (rest < big_dist && unsafe_interval - rest >= ten_kappa &&
+      (rest + ten_kappa < big_dist ||
+       big_dist - rest > rest + ten_kappa - big_dist))
+    return false;
+  return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+/**
+ * Grisu3: shortest digits of a positive finite double in d[0..*n), with
+ * value 0.d * 10^*dp. Fails for about 0.5% of inputs, for which the exact
+ * computation has to be used.
+ */
+static bool jsmn_grisu3(const uint64_t mant, const int exp, unsigned char *d,
+                        int *n, int *dp)
+{
+  static const uint32_t pow10_u32[] = {1,       10,       100,     1000,
+                                       10000,   100000,   1000000, 10000000,
+                                       100000000, 1000000000};
+  struct jsmn_diyfp w, hi, lo, c, too_low, too_high;
+  uint64_t one, unit = 1, unsafe, frac, rest, hix;
+  uint32_t integ;
+  int shift, q, ce, kappa, len = 0;
+
+  /* Neighbour midpoints, lo on hi's scale; below a power of two the gap
+   * is half as wide */
+  hi.f = (mant << 1) + 1;
+  hi.e = exp - JSMN_F64_MANTBITS - 1;
+  shift = jsmn_clz64(hi.f);
+  hi.f <<= shift;
+  hi.e -= shift;
+  if (mant == (uint64_t)1 << JSMN_F64_MANTBITS && exp > JSMN_F64_BIAS + 1) {
+    lo.f = (mant << 2) - 1;
+    lo.e = exp - JSMN_F64_MANTBITS - 2;
+  } else {
+    lo.f = (mant << 1) - 1;
+    lo.e = exp - JSMN_F64_MANTBITS - 1;
+  }
+  lo.f <<= lo.e - hi.e;
+  lo.e = hi.e;
+  shift = jsmn_clz64(mant);
+  w.f = mant << shift;
+  w.e = exp - JSMN_F64_MANTBITS - shift;
+
+  /* Pick 10^q so that the scaled exponent falls in [-60, -32] */
+  q = (int)(((int64_t)(-60 - (w.e + 64) + 63) * 78913 + (1 << 18) - 1) >> 18);
+  for (;; q++) {
+    ce = ((217706 * q) >> 16) - 63;
+    if (ce >= -60 - (w.e + 64))
+      break;
+  }
+  if (q < JSMN_POW5_MIN || q > JSMN_POW5_MAX)
+    return false;
+  c.f = jsmn_pow5_128[q - JSMN_POW5_MIN][0];
+  c.f += jsmn_pow5_128[q - JSMN_POW5_MIN][1] >> 63;
+  c.e = ce;
+  w = jsmn_diyfp_mul(w, c);
+  hi = jsmn_diyfp_mul(hi, c);
+  lo = jsmn_diyfp_mul(lo, c);
+
+  /* Generate digits while they stay within the unsafe interval */
+  too_low.f = lo.f - unit;
+  too_high.f = hi.f + unit;
+  too_low.e = too_high.e = w.e;
+  unsafe = too_high.f - too_low.f;
+  one = (uint64_t)1 << -w.e;
+  integ = (uint32_t)(too_high.f >> -w.e);
+  frac = too_high.f & (one - 1);
+  hix = too_high.f - w.f;
+  for (kappa = 10; kappa > 0 && pow10_u32[kappa - 1] > integ; kappa--)
+    ;
+  while (kappa > 0) {
+    const uint32_t div = pow10_u32[kappa - 1];
+    d[len++] = (unsigned char)(integ / div);
+    integ %= div;
+    kappa--;
+    rest = ((uint64_t)integ << -w.e) + frac;
+    if (rest < unsafe) {
+      *n = len;
+      *dp = len + kappa - q;
+      return jsmn_grisu_weed(d, len, hix, unsafe, rest,
+                             (uint64_t)div << -w.e, unit);
+    }
+  }
+  for (;;) {
+    frac *= 10;
+    unit *= 10;
+    unsafe *= 10;
+    d[len++] = (unsigned char)(frac >> -w.e);
+    frac &= one - 1;
+    kappa--;
+    if (frac < unsafe) {
+      *n = len;
+      *dp = len + kappa - q;
+      return jsmn_grisu_weed(d, len, hix * unit, unsafe, frac, one, unit);
+    }
+  }
+}
+
+/**
+ * Tries Grisu3 and falls back to the exact decimal when it cannot decide.
+ */
+JSMN_API size_t jsmn_format_f64(char *buf, const double v)
+{
+  struct jsmn_decimal d;
+  unsigned char digits[24];
+  uint64_t bits, mant;
+  int exp, n, dp;
+
+  (void)memcpy(&bits, &v, sizeof(bits));
+  mant = bits & (((uint64_t)1 << JSMN_F64_MANTBITS) - 1);
+  exp = (int)(bits >> JSMN_F64_MANTBITS) & 0x7FF;
+  if (exp == 0x7FF)
+    return 0;
+  if (exp == 0)
+    exp++;
+  else
+    mant |= (uint64_t)1 << JSMN_F64_MANTBITS;
+  exp += JSMN_F64_BIAS;
+
+  if (mant == 0)
+    return jsmn_format_digits(buf, bits >> 63, NULL, 0, 0);
+  if (jsmn_grisu3(mant, exp, digits, &n, &dp)) {
+    /* Drop the trailing zeros of integers */
+    while (n > 1 && digits[n - 1] == 0)
+      n--;
+    return jsmn_format_digits(buf, bits >> 63, digits, n, dp);
+  }
+  jsmn_decimal_assign(&d, mant);
+  jsmn_decimal_shift(&d, exp - JSMN_F64_MANTBITS);
+  jsmn_decimal_shortest(&d, mant, exp);
+  return jsmn_format_digits(buf, bits >> 63, d.d, d.nd, d.dp);
+}
+
+static const char jsmn_digits2[] = "00010203040506070809"
+                                   "10111213141516171819"
+                                   "20212223242526272829"
+                                   "30313233343536373839"
+                                   "40414243444546474849"
+                                   "50515253545556575859"
+                                   "60616263646566676869"
+                                   "70717273747576777879"
+                                   "80818283848586878889"
+                                   "90919293949596979899";
+
+/**
+ * Writes two digits per division from the end of a scratch buffer.
+ */
+JSMN_API size_t jsmn_format_u64(char *buf, uint64_t v)
+{
+  char tmp[20];
+  char *p = tmp + sizeof(tmp);
+  size_t n;
+
+  while (v >= 100) {
+    const unsigned r = (unsigned)(v % 100);
+    v /= 100;
+    p -= 2;
+    (void)memcpy(p, jsmn_digits2 + 2 * r, 2);
+  }
+  if (v >= 10) {
+    p -= 2;
+    (void)memcpy(p, jsmn_digits2 + 2 * v, 2);
+  } else {
+    *--p = (char)('0' + v);
+  }
+  n = tmp + sizeof(tmp) - p;
+  (void)memcpy(buf, p, n);
+  return n;
+}
+
+JSMN_API size_t jsmn_format_i64(char *buf, const int64_t v)
+{
+  if (v >= 0)
+    return jsmn_format_u64(buf, (uint64_t)v);
+  buf[0] = '-';
+  /* Negate unsigned so INT64_MIN works */
+  return 1 + jsmn_format_u64(buf + 1, ~(uint64_t)v + 1);
+}
+
+/*
+ * Writer.
+ */
+
+JSMN_API void jsmn_writer_init(jsmn_writer *w, jsmn_sink *sink)
+{
+  w->sink = sink;
+  w->depth = 0;
+  w->objects = 0;
+  w->nonempty = 0;
+  w->want_value = false;
+  w->error = JSMN_SUCCESS;
+}
+
+static inline enum jsmnerr jsmn_writer_put(jsmn_writer *w, const char *data,
+                                           const size_t n)
+{
+  if (w->error == JSMN_SUCCESS)
+    w->error = jsmn_sink_write(w->sink, data, n);
+  return w->error;
+}
+
+/**
+ * Checks that a key (or a value) may come next and writes the separator
+ * before it.
+ */
+static enum jsmnerr jsmn_writer_next(jsmn_writer *w, const bool key)
+{
+  const uint64_t bit = (uint64_t)1 << w->depth;
+  const bool object = (w->objects & bit) != 0;
+
+  if (w->error != JSMN_SUCCESS)
+    return w->error;
+  if (key != (object && !w->want_value)) {
+    w->error = JSMN_ERROR_INVAL;
+    return w->error;
+  }
+  if (w->want_value) {
+    w->want_value = false;
+    return JSMN_SUCCESS;
+  }
+  if (w->nonempty & bit) {
+    /* Top-level values go on lines of their own */
+    if (jsmn_writer_put(w, w->depth == 0 ? "\n" : ",", 1) != JSMN_SUCCESS)
+      return w->error;
+  }
+  w->nonempty |= bit;
+  return JSMN_SUCCESS;
+}
+
+/**
+ * Writes s[0..n) as a quoted string. Runs of bytes that need no escaping
+ * are found 8 at a time and copied as they are.
+ */
+static enum jsmnerr jsmn_writer_quoted(jsmn_writer *w, const char *s,
+                                       const size_t n)
+{
+  static const char hex[] = "0123456789abcdef";
+  size_t i = 0, run = 0;
+
+  jsmn_writer_put(w, "\"", 1);
+  while (w->error == JSMN_SUCCESS) {
+    char esc[6] = {'\\', 'u', '0', '0'};
+    size_t len = 2;
+    unsigned char c;
+
+    for (; n - i >= 8; i += 8) {
+      const uint64_t v = jsmn_read64le(s + i);
+      if (JSMN_HASBYTE(v, '\"') | JSMN_HASBYTE(v, '\\') |
+          JSMN_HASLESS(v, 0x20))
+        break;
+    }
+    for (; i < n; i++) {
+      c = (unsigned char)s[i];
+      if (c == '\"' || c == '\\' || c < 0x20)
+        break;
+    }
+    if (jsmn_writer_put(w, s + run, i - run) != JSMN_SUCCESS || i == n)
+      break;
+
+    c = (unsigned char)s[i];
+    switch (c) {
+    case '\"':
+    case '\\':
+      esc[1] = (char)c;
+      break;
+    case '\b':
+      esc[1] = 'b';
+      break;
+    case '\f':
+      esc[1] = 'f';
+      break;
+    case '\n':
+      esc[1] = 'n';
+      break;
+    case '\r':
+      esc[1] = 'r';
+      break;
+    case '\t':
+      esc[1] = 't';
+      break;
+    default:
+      esc[4] = hex[c >> 4];
+      esc[5] = hex[c & 0xF];
+      len = 6;
+    }
+    jsmn_writer_put(w, esc, len);
+    run = ++i;
+  }
+  return jsmn_writer_put(w, "\"", 1);
+}
+
+static enum jsmnerr jsmn_writer_begin(jsmn_writer *w, const bool object)
+{
+  if (jsmn_writer_next(w, false) != JSMN_SUCCESS)
+    return w->error;
+  if (w->depth == JSMN_WRITER_DEPTH) {
+    w->error = JSMN_ERROR_NOMEM;
+    return w->error;
+  }
+  w->depth++;
+  if (object)
+    w->objects |= (uint64_t)1 << w->depth;
+  else
+    w->objects &= ~((uint64_t)1 << w->depth);
+  w->nonempty &= ~((uint64_t)1 << w->depth);
+  return jsmn_writer_put(w, object ? "{" : "[", 1);
+}
+
+static enum jsmnerr jsmn_writer_end(jsmn_writer *w, const bool object)
+{
+  if (w->error != JSMN_SUCCESS)
+    return w->error;
+  if (w->depth == 0 || w->want_value ||
+      ((w->objects >> w->depth) & 1) != (uint64_t)object) {
+    w->error = JSMN_ERROR_INVAL;
+    return w->error;
+  }
+  w->depth--;
+  return jsmn_writer_put(w, object ? "}" : "]", 1);
+}
+
+JSMN_API enum jsmnerr jsmn_writer_begin_object(jsmn_writer *w)
+{
+  return jsmn_writer_begin(w, true);
+}
+
+JSMN_API enum jsmnerr jsmn_writer_end_object(jsmn_writer *w)
+{
+  return jsmn_writer_end(w, true);
+}
+
+JSMN_API enum jsmnerr jsmn_writer_begin_array(jsmn_writer *w)
+{
+  return jsmn_writer_begin(w, false);
+}
+
+JSMN_API enum jsmnerr jsmn_writer_end_array(jsmn_writer *w)
+{
+  return jsmn_writer_end(w, false);
+}
+
+JSMN_API enum jsmnerr jsmn_writer_key(jsmn_writer *w, const char *key,
+                                      const size_t len)
+{
+  if (jsmn_writer_next(w, true) != JSMN_SUCCESS ||
+      jsmn_writer_quoted(w, key, len) != JSMN_SUCCESS)
+    return w->error;
+  w->want_value = true;
+  return jsmn_writer_put(w, ":", 1);
+}
+
+JSMN_API enum jsmnerr jsmn_writer_string(jsmn_writer *w, const char *s,
+                                         const size_t len)
+{
+  if (jsmn_writer_next(w, false) != JSMN_SUCCESS)
+    return w->error;
+  return jsmn_writer_quoted(w, s, len);
+}
+
+JSMN_API enum jsmnerr jsmn_writer_i64(jsmn_writer *w, const int64_t v)
+{
+  char buf[JSMN_FORMAT_MAX];
+
+  if (jsmn_writer_next(w, false) != JSMN_SUCCESS)
+    return w->error;
+  return jsmn_writer_put(w, buf, jsmn_format_i64(buf, v));
+}
+
+JSMN_API enum jsmnerr jsmn_writer_u64(jsmn_writer *w, const uint64_t v)
+{
+  char buf[JSMN_FORMAT_MAX];
+
+  if (jsmn_writer_next(w, false) != JSMN_SUCCESS)
+    return w->error;
+  return jsmn_writer_put(w, buf, jsmn_format_u64(buf, v));
+}
+
+JSMN_API enum jsmnerr jsmn_writer_f64(jsmn_writer *w, const double v)
+{
+  char buf[JSMN_FORMAT_MAX];
+
+  if (v != v || v - v != 0) {
+    /* JSON has no NaN or infinity */
+    if (w->error == JSMN_SUCCESS)
+      w->error = JSMN_ERROR_RANGE;
+    return w->error;
+  }
+  if (jsmn_writer_next(w, false) != JSMN_SUCCESS)
+    return w->error;
+  return jsmn_writer_put(w, buf, jsmn_format_f64(buf, v));
+}
+
+JSMN_API enum jsmnerr jsmn_writer_bool(jsmn_writer *w, const bool v)
+{
+  if (jsmn_writer_next(w, false) != JSMN_SUCCESS)
+    return w->error;
+  return v ? jsmn_writer_put(w, "true", 4) : jsmn_writer_put(w, "false", 5);
+}
+
+JSMN_API enum jsmnerr jsmn_writer_null(jsmn_writer *w)
+{
+  if (jsmn_writer_next(w, false) != JSMN_SUCCESS)
+    return w->error;
+  return jsmn_writer_put(w, "null", 4);
+}
+
+/**
+ * Copies the source bytes of a token, and of its subtree for containers.
+ */
+JSMN_API enum jsmnerr jsmn_writer_token(jsmn_writer *w, const char *js,
+                                        const jsmntok_t *tok)
+{
+  const bool quoted = tok->type == JSMN_STRING && !tok->opaque;
+  const size_t start = quoted ? tok->start - 1 : tok->start;
+  const size_t end = quoted ? tok->end + 1 : tok->end;
+
+  if (w->error == JSMN_SUCCESS && tok->unclosed)
+    w->error = JSMN_ERROR_INVAL;
+  if (jsmn_writer_next(w, tok->is_key) != JSMN_SUCCESS ||
+      jsmn_writer_put(w, js + start, end - start) != JSMN_SUCCESS)
+    return w->error;
+  if (tok->is_key) {
+    w->want_value = true;
+    return jsmn_writer_put(w, ":", 1);
+  }
+  return JSMN_SUCCESS;
+}
+
+/**
+ * Checks that all containers are closed and flushes the sink.
+ */
+JSMN_API enum jsmnerr jsmn_writer_finish(jsmn_writer *w)
+{
+  if (w->error == JSMN_SUCCESS && (w->depth > 0 || w->want_value))
+    w->error = JSMN_ERROR_INVAL;
+  if (w->error == JSMN_SUCCESS)
+    w->error = jsmn_sink_flush(w->sink);
+  return w->error;
+}
+
+/*
+ * Reformatting.
+ */
+
+static inline bool jsmn_is_ws(const char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/**
+ * Returns the index of the quote that closes the string whose contents
+ * start at js[i], or len if it is not closed. Runs without quotes or
+ * backslashes are skipped 8 bytes at a time.
+ */
+static size_t jsmn_string_end(const char *js, const size_t len, size_t i)
+{
+  for (;;) {
+    for (; len - i >= 8; i += 8) {
+      const uint64_t v = jsmn_read64le(js + i);
+      if (JSMN_HASBYTE(v, '\"') | JSMN_HASBYTE(v, '\\'))
+        break;
+    }
+    for (; i < len && js[i] != '\"' && js[i] != '\\'; i++)
+      ;
+    if (i >= len || js[i] == '\"')
+      return i < len ? i : len;
+    /* Skip the escaped character */
+    i += 2;
+    if (i > len)
+      return len;
+  }
+}
+
+/**
+ * Copies everything but whitespace outside strings. Runs without
+ * whitespace or quotes are moved 8 bytes at a time, strings in one piece.
+ */
+JSMN_API enum jsmnerr jsmn_minify(const char *js, const size_t len,
+                                  char *out, size_t *outlen)
+{
+  size_t i = 0, o = 0;
+
+  while (i < len) {
+    char c;
+
+    for (; len - i >= 8; i += 8, o += 8) {
+      const uint64_t v = jsmn_read64le(js + i);
+      if (JSMN_HASLESS(v, 0x21) | JSMN_HASBYTE(v, '\"'))
+        break;
+      (void)memmove(out + o, js + i, 8);
+    }
+    if (i == len)
+      break;
+    c = js[i++];
+    if (jsmn_is_ws(c))
+      continue;
+    out[o++] = c;
+    if (c == '\"') {
+      const size_t end = jsmn_string_end(js, len, i);
+      if (end == len) {
+        (void)memmove(out + o, js + i, len - i);
+        *outlen = o + len - i;
+        return JSMN_ERROR_UNCLOSED_STRING;
+      }
+      (void)memmove(out + o, js + i, end + 1 - i);
+      o += end + 1 - i;
+      i = end + 1;
+    }
+  }
+  *outlen = o;
+  return JSMN_SUCCESS;
+}
+
+static enum jsmnerr jsmn_pretty_newline(jsmn_sink *out, const char *indent,
+                                        const size_t indentlen,
+                                        unsigned int depth)
+{
+  enum jsmnerr r = jsmn_sink_write(out, "\n", 1);
+
+  for (; depth > 0 && r == JSMN_SUCCESS; depth--)
+    r = jsmn_sink_write(out, indent, indentlen);
+  return r;
+}
+
+/**
+ * Re-spaces the document byte by byte: strings and primitives are copied
+ * as whole spans, whitespace is dropped and regenerated around the
+ * structural characters.
+ */
+JSMN_API enum jsmnerr jsmn_prettify(const char *js, const size_t len,
+                                    jsmn_sink *out, const char *indent)
+{
+  const size_t indentlen = strlen(indent);
+  unsigned int depth = 0;
+  bool started = false;
+  enum jsmnerr r = JSMN_SUCCESS;
+  size_t i = 0;
+
+  while (i < len && r == JSMN_SUCCESS) {
+    const char c = js[i];
+    size_t j;
+
+    switch (c) {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+      i++;
+      break;
+    case '{':
+    case '[':
+      if (depth == 0 && started)
+        r = jsmn_sink_write(out, "\n", 1);
+      started = true;
+      if (r == JSMN_SUCCESS)
+        r = jsmn_sink_write(out, &c, 1);
+      /* Keep empty containers on one line */
+      for (j = i + 1; j < len && jsmn_is_ws(js[j]); j++)
+        ;
+      if (j < len && (js[j] == '}' || js[j] == ']')) {
+        if (r == JSMN_SUCCESS)
+          r = jsmn_sink_write(out, js + j, 1);
+        i = j + 1;
+        break;
+      }
+      depth++;
+      if (r == JSMN_SUCCESS)
+        r = jsmn_pretty_newline(out, indent, indentlen, depth);
+      i++;
+      break;
+    case '}':
+    case ']':
+      if (depth > 0)
+        depth--;
+      r = jsmn_pretty_newline(out, indent, indentlen, depth);
+      if (r == JSMN_SUCCESS)
+        r = jsmn_sink_write(out, &c, 1);
+      i++;
+      break;
+    case ',':
+      r = jsmn_sink_write(out, ",", 1);
+      if (r == JSMN_SUCCESS)
+        r = jsmn_pretty_newline(out, indent, indentlen, depth);
+      i++;
+      break;
+    case ':':
+      r = jsmn_sink_write(out, ": ", 2);
+      i++;
+      break;
+    case '\"':
+      j = jsmn_string_end(js, len, i + 1);
+      if (depth == 0 && started)
+        r = jsmn_sink_write(out, "\n", 1);
+      started = true;
+      if (r == JSMN_SUCCESS)
+        r = jsmn_sink_write(out, js + i, (j < len ? j + 1 : len) - i);
+      if (r == JSMN_SUCCESS && j == len)
+        return JSMN_ERROR_UNCLOSED_STRING;
+      i = j + 1;
+      break;
+    default:
+      for (j = i + 1; j < len && !jsmn_is_ws(js[j]) && js[j] != ',' &&
+                      js[j] != ':' && js[j] != '}' && js[j] != ']' &&
+                      js[j] != '{' && js[j] != '[' && js[j] != '\"';
+           j++)
+        ;
+      if (depth == 0 && started)
+        r = jsmn_sink_write(out, "\n", 1);
+      started = true;
+      if (r == JSMN_SUCCESS)
+        r = jsmn_sink_write(out, js + i, j - i);
+      i = j;
+    }
+  }
+  return r;
+}
+
+/**
+ * Counts the values and keys: strings, brackets that open containers and
+ * the first byte of every primitive.
+ */
+JSMN_API size_t jsmn_count_tokens(const char *js, const size_t len)
+{
+  size_t i = 0, n = 0;
+  bool primitive = false;
+
+  while (i < len) {
+    const char c = js[i];
+
+    switch (c) {
+    case '\"':
+      n++;
+      primitive = false;
+      i = jsmn_string_end(js, len, i + 1) + 1;
+      continue;
+    case '{':
+    case '[':
+      n++;
+      primitive = false;
+      break;
+    case '}':
+    case ']':
+    case ',':
+    case ':':
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+      primitive = false;
+      break;
+    default:
+      if (!primitive)
+        n++;
+      primitive = true;
+    }
+    i++;
+  }
+  return n;
+}
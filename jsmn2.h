@@ -72,27 +72,221 @@ enum jsmnerr {
   JSMN_ERROR_UNEXPECTED_EOF = -7,
   JSMN_ERROR_TRAILING_COMMA = -8,
   JSMN_ERROR_EXPECTED_EOF = -9,
+  /* Token is not a JSON number */
+  JSMN_ERROR_NOT_NUMBER = -10,
+  /* Number does not fit into the requested type */
+  JSMN_ERROR_RANGE = -11,
+  /* Number has a fraction or an exponent but an integer was requested */
+  JSMN_ERROR_NOT_INTEGER = -12,
+  /* Array is not a rectangular array of numbers */
+  JSMN_ERROR_SHAPE = -13,
+  /* String is not valid UTF-8 or has an unpaired surrogate escape */
+  JSMN_ERROR_INVALID_UTF8 = -14,
+  /* The flush callback of an output sink failed */
+  JSMN_ERROR_FLUSH = -15,
+  /* Objects and arrays are nested deeper than parser->max_depth */
+  JSMN_ERROR_TOO_DEEP = -16,
+  /* A string is longer than parser->max_string bytes */
+  JSMN_ERROR_TOO_LONG = -17,
+  /* The document needs more than parser->max_tokens tokens */
+  JSMN_ERROR_TOO_MANY_TOKENS = -18,
+  /* The document is longer than parser->max_bytes bytes */
+  JSMN_ERROR_TOO_BIG = -19,
+  /* All required keys were found, the rest of the input was not parsed */
+  JSMN_EARLY_EXIT = 1,
+  /* The work budget of the call ran out, call again with the same input */
+  JSMN_YIELD = 2,
+};
+
+/**
+ * Parser options, set in jsmn_parser.flags after jsmn_init().
+ */
+enum jsmnflag {
+  /* Validate UTF-8 and \uXXXX surrogate pairs inside strings */
+  JSMN_VALIDATE_UTF8 = 1 << 0,
+  /* Return JSMN_SUCCESS after each complete top-level value instead of
+   * rejecting the next one; drop it with jsmn_discard() to go on */
+  JSMN_STREAM = 1 << 1,
 };
 
 /**
  * JSON token description.
  * type         type (object, array, string etc.)
  * start        start position in JSON data string
+ * end          end position (exclusive): the closing quote of a string, one
+ *              past the closing bracket of an object or array, so the span
+ *              js[start..end) of a container is its raw JSON text. Not set
+ *              while the token is unclosed.
  * size         length of this token. For non-literal types, this corresponds to
  *              the number of elements.
+ * has_escapes  string contains backslash escapes. Strings without escapes
+ *              can be used as-is from the JSON data.
+ * opaque       object or array below the materialization depth, left
+ *              untokenized: it has no child tokens and a size of 0, its
+ *              text is js[start..end). See jsmn_expand().
+ * split        the string or primitive spans more than one input segment,
+ *              see jsmn_parse_iov().
  */
 typedef struct {
   size_t start;
+  size_t end;
   int size;
 #ifdef JSMN_PARENT_LINKS
   int parent;
+#endif
+#ifdef JSMN_SYMTAB
+  int sym; /* symbol id of a key, JSMN_SYM_UNKNOWN otherwise */
 #endif
   jsmntype_t type:4;
   bool unclosed:1;
   bool is_key:1;
   bool associated:1;
+  bool has_escapes:1;
+  bool opaque:1;
+  bool split:1;
 } jsmntok_t;
 
+#ifdef JSMN_SYMTAB
+#define JSMN_SYM_UNKNOWN (-1)
+
+typedef struct {
+  uint32_t hash;
+  int id;            /* JSMN_SYM_UNKNOWN for an empty slot */
+  unsigned int off;  /* name in the name buffer */
+  unsigned int len;
+} jsmn_sym;
+
+/**
+ * Symbol table for object keys, shared across documents. Slots and names
+ * are caller-owned storage; ids are handed out sequentially from 0, so
+ * names added up front in a fixed order get fixed ids that can be used as
+ * case labels. Set add to also intern unknown keys met while parsing.
+ */
+typedef struct jsmn_symtab {
+  jsmn_sym *slots;
+  unsigned int nslots;  /* power of two */
+  unsigned int count;   /* symbols interned */
+  char *names;          /* decoded names, not NUL-terminated */
+  size_t namecap, namelen;
+  bool add;             /* intern unknown keys while parsing */
+} jsmn_symtab;
+#endif
+
+/**
+ * Shape cache sizes: keys and raw key bytes remembered per object shape,
+ * and the nesting depth up to which objects are tracked.
+ */
+#ifndef JSMN_SHAPE_KEYS
+#define JSMN_SHAPE_KEYS 32
+#endif
+#ifndef JSMN_SHAPE_BYTES
+#define JSMN_SHAPE_BYTES 512
+#endif
+#ifndef JSMN_SHAPE_DEPTH
+#define JSMN_SHAPE_DEPTH 16
+#endif
+
+/**
+ * Key sequence of the last object seen at one path. Keys are stored as
+ * their raw bytes including both quotes, back to back.
+ */
+typedef struct {
+  uint32_t path;         /* signature of the path to the object */
+  unsigned int nkeys;
+  unsigned int nbytes;
+  struct {
+    uint32_t hash;       /* hash of the raw key bytes */
+    unsigned short len;  /* raw length including the quotes */
+    bool has_escapes:1;
+    bool checked:1;      /* recorded with JSMN_VALIDATE_UTF8 */
+#ifdef JSMN_SYMTAB
+    int sym;
+#endif
+  } keys[JSMN_SHAPE_KEYS];
+  char bytes[JSMN_SHAPE_BYTES];
+} jsmn_shape;
+
+/**
+ * Caller-owned cache of object shapes, keyed by path and kept across
+ * documents. Shapes are direct-mapped by path signature into nshapes
+ * entries (a power of two).
+ */
+typedef struct jsmn_shape_cache {
+  jsmn_shape *shapes;
+  unsigned int nshapes;
+  unsigned long hits, misses; /* key predictions */
+  struct {
+    uint32_t path;      /* signature of this container */
+    uint32_t key;       /* hash of the current key (objects) */
+    int shape;          /* shape of this object, -1 if none */
+    bool object;
+    unsigned int k;     /* next key in the shape */
+    unsigned int off;   /* its offset in shape bytes */
+  } stack[JSMN_SHAPE_DEPTH];
+} jsmn_shape_cache;
+
+#ifndef JSMN_PATH_DEPTH
+#define JSMN_PATH_DEPTH 16
+#endif
+/* Edge kinds besides array indexes */
+#define JSMN_PATH_ANY (-1) /* [*] */
+#define JSMN_PATH_KEY (-2) /* object key */
+
+typedef struct {
+  uint32_t hash;       /* hash of the key */
+  unsigned int parent; /* node the edge leaves */
+  unsigned int child;  /* node the edge leads to */
+  int index;           /* array index, JSMN_PATH_ANY or JSMN_PATH_KEY */
+  const char *name;    /* key, points into the path string */
+  unsigned int len;
+} jsmn_path_edge;
+
+typedef struct {
+  unsigned int first; /* first edge leaving this node */
+  unsigned int nkeys; /* key edges, sorted by hash */
+  unsigned int nidx;  /* then [*] and index edges, sorted by index */
+  bool terminal;      /* a path ends here */
+  int subs;           /* first subscription or rewrite ending here, or -1 */
+  unsigned int nsubs; /* subscriptions: run of subs[].order from subs */
+} jsmn_path_node;
+
+/**
+ * Set of paths compiled into a trie over caller-owned nodes and edges.
+ * Node 0 is the root object.
+ */
+typedef struct {
+  jsmn_path_node *nodes;
+  unsigned int nnodes, nodecap;
+  jsmn_path_edge *edges;
+  unsigned int nedges, edgecap;
+} jsmn_paths;
+
+/**
+ * Projection state of a parser, see jsmn_projection_init().
+ */
+typedef struct jsmn_projection {
+  const jsmn_paths *paths;
+  unsigned int all; /* depth of the subtree copied in full, 0 if none */
+  struct {
+    unsigned int node;  /* trie node of this container */
+    unsigned int index; /* elements seen so far (arrays) */
+    unsigned int next;  /* trie node of the current value */
+    unsigned int at;    /* position of the current element (arrays) */
+  } stack[JSMN_PATH_DEPTH];
+} jsmn_projection;
+
+#define JSMN_REQUIRED_MAX 32
+
+/**
+ * Top-level keys a caller needs, see jsmn_required_init().
+ */
+typedef struct jsmn_required {
+  const char *const *keys;
+  unsigned int nkeys;
+  uint32_t found;   /* bit i: the value of keys[i] was tokenized */
+  uint32_t pending; /* bit of the key whose value is being tokenized */
+} jsmn_required;
+
 /**
  * JSON parser. Contains an array of token blocks available. Also stores
  * the string being parsed now and current position in that string.
@@ -102,7 +296,28 @@ typedef struct jsmn_parser {
   unsigned int toknext; /* next token to allocate */
   unsigned int line, col; /* current line and col number */
   int toksuper;         /* superior token node, e.g. parent object or array */
+  int tokopen;          /* innermost open object or array, -1 if none */
+  unsigned int flags;   /* enum jsmnflag options */
+  unsigned int depth;   /* number of open objects and arrays */
+  unsigned int shallow; /* deepest level to tokenize, 0 for all */
+  unsigned int budget;  /* bytes to parse per call, 0 for no limit */
+  unsigned int tokbudget; /* tokens to emit per call, 0 for no limit */
+  unsigned int max_depth;  /* limits per document, 0 for none: nesting, */
+  unsigned int max_string; /* raw bytes of a string, */
+  unsigned int max_tokens; /* tokens */
+  unsigned int max_bytes;  /* and input bytes */
   bool __last_is_comma:1;
+  bool __skip_str:1;         /* value being skipped: inside a string, */
+  bool __skip_opaque:1;      /* for an opaque token, */
+  char __skip_open;          /* its first byte, 0 if none is pending, */
+  unsigned int __skip_depth; /* and its open brackets */
+  unsigned int __insitu_nul; /* pending NUL terminator (in-situ mode) */
+#ifdef JSMN_SYMTAB
+  jsmn_symtab *symtab;  /* assigns key symbols while parsing, may be NULL */
+#endif
+  jsmn_shape_cache *shapes; /* predicts object keys, may be NULL */
+  jsmn_projection *proj;    /* only tokenizes the selected paths, may be NULL */
+  jsmn_required *required;  /* stops once these keys are found, may be NULL */
   jsmntok_t tokbuf;
 } jsmn_parser;
 
@@ -115,10 +330,585 @@ JSMN_API void jsmn_init(jsmn_parser *parser);
  * Run JSON parser. It parses a JSON data string into and array of tokens, each
  * describing
  * a single JSON object.
+ *
+ * With parser->budget or parser->tokbudget set, a call stops with JSMN_YIELD
+ * once it has gone that many bytes past where it started, or emitted that
+ * many tokens. Budgets are checked between tokens, so one token may overrun
+ * them. Values skipped by a projection or kept opaque by parser->shallow
+ * are no tokens but byte runs: their scan stops at the budget too, and an
+ * opaque token has no end until it is done. The next call goes on exactly
+ * where the last one stopped.
+ *
+ * The limits parser->max_depth, max_string, max_tokens and max_bytes reject
+ * a document as soon as it goes past one of them, with JSMN_ERROR_TOO_DEEP,
+ * JSMN_ERROR_TOO_LONG, JSMN_ERROR_TOO_MANY_TOKENS or JSMN_ERROR_TOO_BIG.
+ * Past max_bytes the parser only reads whitespace after a complete
+ * document, which does not count against the limit, and it never reads
+ * more than max_string bytes into a string.
  */
 JSMN_API enum jsmnerr jsmn_parse(jsmn_parser *parser, const char *js, const size_t len,
                         jsmntok_t *tokens, const unsigned int num_tokens);
 
+/**
+ * In-situ variant of jsmn_parse() for buffers the caller owns and no longer
+ * needs in their original form. Strings are unescaped in place and every
+ * string and primitive is NUL-terminated, so js + tok->start can be used as
+ * a C string of tok->size bytes (has_escapes is always cleared). The bytes
+ * of js are overwritten; container spans are no longer valid JSON. A \u
+ * escape of a lone surrogate, which has no UTF-8 encoding, fails with
+ * JSMN_ERROR_INVALID_UTF8 whether or not JSMN_VALIDATE_UTF8 is set.
+ */
+JSMN_API enum jsmnerr jsmn_parse_insitu(jsmn_parser *parser, char *js,
+                                        const size_t len, jsmntok_t *tokens,
+                                        const unsigned int num_tokens);
+
+/**
+ * Tokenize an opaque object or array of a shallow parse. Containers that
+ * would open below parser->shallow levels are emitted as one opaque token
+ * spanning their bytes, after a balanced-bracket scan that only checks
+ * strings and brackets. parser must be freshly initialized with
+ * jsmn_init(); its options (including shallow, relative to the opaque
+ * token) apply. Token positions stay offsets into js.
+ */
+JSMN_API enum jsmnerr jsmn_expand(jsmn_parser *parser, const char *js,
+                                  const jsmntok_t *opaque, jsmntok_t *tokens,
+                                  const unsigned int num_tokens);
+
+/**
+ * Decode a primitive token as a number. The token span is parsed in place
+ * (no NUL terminator needed, locale independent). Return
+ * JSMN_ERROR_NOT_NUMBER if the token is not a valid JSON number,
+ * JSMN_ERROR_NOT_INTEGER if an integer is requested from a number with a
+ * fraction or an exponent, and JSMN_ERROR_RANGE on overflow. Doubles are
+ * correctly rounded; on overflow *out is set to +/-infinity.
+ */
+JSMN_API enum jsmnerr jsmn_get_i64(const char *js, const jsmntok_t *tok,
+                                   int64_t *out);
+JSMN_API enum jsmnerr jsmn_get_u64(const char *js, const jsmntok_t *tok,
+                                   uint64_t *out);
+JSMN_API enum jsmnerr jsmn_get_f64(const char *js, const jsmntok_t *tok,
+                                   double *out);
+
+/**
+ * Convert all numbers of the array token tokens[idx] into out. Nested
+ * rectangular arrays are flattened in row-major order. *count receives the
+ * number of elements; if it exceeds outcap JSMN_ERROR_NOMEM is returned and
+ * nothing is written. Ragged or mixed arrays give JSMN_ERROR_SHAPE, opaque
+ * arrays of a shallow parse JSMN_ERROR_INVAL, other errors are the same as
+ * for the jsmn_get_* functions.
+ */
+JSMN_API enum jsmnerr jsmn_array_to_f64(const char *js,
+                                        const jsmntok_t *tokens,
+                                        const unsigned int num_tokens,
+                                        const unsigned int idx, double *out,
+                                        const size_t outcap, size_t *count);
+JSMN_API enum jsmnerr jsmn_array_to_i64(const char *js,
+                                        const jsmntok_t *tokens,
+                                        const unsigned int num_tokens,
+                                        const unsigned int idx, int64_t *out,
+                                        const size_t outcap, size_t *count);
+
+/**
+ * Decode a string token into out as UTF-8: escapes are resolved and
+ * \uXXXX surrogate pairs are joined. *outlen receives the decoded length;
+ * pass out = NULL to only compute it. The output is not NUL-terminated.
+ * Return JSMN_ERROR_NOMEM if outcap is too small (*outlen is still set)
+ * and JSMN_ERROR_INVAL for malformed escapes or unpaired surrogates.
+ */
+JSMN_API enum jsmnerr jsmn_unescape(const char *js, const jsmntok_t *tok,
+                                    char *out, const size_t outcap,
+                                    size_t *outlen);
+
+/**
+ * Number of objects a jsmn_index can hold hash tables for, and the smallest
+ * object (in keys) that gets one. Smaller objects are searched linearly.
+ */
+#ifndef JSMN_INDEX_OBJECTS
+#define JSMN_INDEX_OBJECTS 16
+#endif
+#ifndef JSMN_INDEX_MIN_KEYS
+#define JSMN_INDEX_MIN_KEYS 16
+#endif
+
+typedef struct {
+  uint32_t hash;
+  int key; /* key token index, -1 for an empty slot */
+} jsmn_index_slot;
+
+/**
+ * Lazily built key indexes for jsmn_object_get(). The slots are an arena
+ * supplied by the caller; each indexed object takes a power of two of at
+ * least twice its key count. An index is only valid for the token array
+ * it was built on, call jsmn_index_init() again before reusing it.
+ */
+typedef struct {
+  jsmn_index_slot *slots;
+  unsigned int nslots; /* arena size */
+  unsigned int used;   /* slots handed out */
+  unsigned int nobjs;  /* entries in dir */
+  struct {
+    unsigned int obj;  /* object token index */
+    unsigned int off;  /* first slot of its table */
+    unsigned int mask; /* table size - 1 */
+  } dir[JSMN_INDEX_OBJECTS];
+} jsmn_index;
+
+JSMN_API void jsmn_index_init(jsmn_index *index, jsmn_index_slot *slots,
+                              const unsigned int nslots);
+
+/**
+ * Find key (keylen bytes, unescaped) in the object tokens[obj] and return
+ * the index of its value token, or -1 if there is no such key. An opaque
+ * object of a shallow parse has no key tokens to search and gives
+ * JSMN_ERROR_INVAL, expand it with jsmn_expand() first. Escaped keys
+ * are compared by their decoded value; with duplicate keys the first one
+ * wins. index may be NULL. Otherwise the first lookup on an object with at
+ * least JSMN_INDEX_MIN_KEYS keys builds a hash table for it, so later
+ * lookups take O(1) expected time. When the arena is exhausted lookups
+ * silently fall back to a linear search.
+ */
+JSMN_API int jsmn_object_get(const char *js, const jsmntok_t *tokens,
+                             const unsigned int num_tokens,
+                             const unsigned int obj, const char *key,
+                             const size_t keylen, jsmn_index *index);
+
+/**
+ * Initialize a shape cache over nshapes entries (a power of two). Assign it
+ * to parser->shapes after jsmn_init() to have jsmn_parse() predict each
+ * object key from the last object seen at the same path: a key that
+ * matches is taken with one memcmp instead of being scanned. The cache is
+ * not used by jsmn_parse_insitu().
+ */
+JSMN_API void jsmn_shape_init(jsmn_shape_cache *cache, jsmn_shape *shapes,
+                              const unsigned int nshapes);
+
+/**
+ * Compile n paths into a trie stored in nodecap nodes and edgecap edges.
+ * A path is a sequence of keys separated by dots, each optionally followed
+ * by array steps: "user.id", "events[*].ts", "matrix[0][2]". Keys are
+ * matched against the decoded object keys and may not contain '.' or '['.
+ * Paths can be added by further calls; the path strings must outlive the
+ * trie. Return JSMN_ERROR_INVAL on a syntax error and JSMN_ERROR_NOMEM if
+ * the storage is exhausted. An index step takes precedence over [*] in the
+ * same position.
+ */
+JSMN_API void jsmn_paths_init(jsmn_paths *paths, jsmn_path_node *nodes,
+                              const unsigned int nodecap,
+                              jsmn_path_edge *edges,
+                              const unsigned int edgecap);
+JSMN_API enum jsmnerr jsmn_paths_compile(jsmn_paths *paths,
+                                         const char *const *list,
+                                         const unsigned int n);
+
+/**
+ * Set up a projection over compiled paths. Assign it to parser->proj after
+ * jsmn_init() to have the parser emit tokens only for the containers that
+ * lead to a selected path and the full subtrees the paths select. Other
+ * object members and array elements get no tokens, and container sizes
+ * only count the emitted children. Skipped values are only checked for
+ * terminated strings and balanced brackets.
+ */
+JSMN_API void jsmn_projection_init(jsmn_projection *proj,
+                                   const jsmn_paths *paths);
+
+/**
+ * Register up to JSMN_REQUIRED_MAX keys (NUL-terminated, matched against
+ * the decoded keys) of the root object. Assign req to parser->required
+ * after jsmn_init() to have jsmn_parse() return JSMN_EARLY_EXIT as soon as
+ * the values of all of them have been tokenized. The tokens so far are
+ * complete, but nothing after them was looked at, so the document may
+ * still turn out to be invalid. Clear parser->required and call
+ * jsmn_parse() again to parse the rest.
+ */
+JSMN_API void jsmn_required_init(jsmn_required *req, const char *const *keys,
+                                 const unsigned int nkeys);
+
+#ifndef JSMN_POINTER_MAX
+#define JSMN_POINTER_MAX 16
+#endif
+#ifndef JSMN_POINTER_BYTES
+#define JSMN_POINTER_BYTES 256
+#endif
+
+/**
+ * Compiled JSON Pointer (RFC 6901): reference tokens with ~0 and ~1
+ * decoded, and their array index if they are one.
+ */
+typedef struct {
+  unsigned int n; /* reference tokens, 0 for the whole document */
+  struct {
+    unsigned short off; /* name in names */
+    unsigned short len;
+    int index; /* array index, -1 if the token is not one */
+  } refs[JSMN_POINTER_MAX];
+  char names[JSMN_POINTER_BYTES];
+} jsmn_pointer;
+
+/**
+ * Compile the pointer s of len bytes, e.g. "/a/b/3/c". Return
+ * JSMN_ERROR_INVAL if it is not a valid pointer and JSMN_ERROR_NOMEM if it
+ * exceeds JSMN_POINTER_MAX tokens or JSMN_POINTER_BYTES bytes.
+ */
+JSMN_API enum jsmnerr jsmn_pointer_compile(jsmn_pointer *ptr, const char *s,
+                                           const size_t len);
+
+/**
+ * Return the index of the token ptr refers to, or -1 if there is none.
+ * Siblings are jumped over by their end offsets without visiting their
+ * subtrees. jsmn_pointer_get_many() resolves n pointers (at most 64) in a
+ * single walk and stores the results in out.
+ */
+JSMN_API int jsmn_pointer_get(const char *js, const jsmntok_t *tokens,
+                              const unsigned int num_tokens,
+                              const jsmn_pointer *ptr);
+JSMN_API void jsmn_pointer_get_many(const char *js, const jsmntok_t *tokens,
+                                    const unsigned int num_tokens,
+                                    const jsmn_pointer *ptrs,
+                                    const unsigned int n, int *out);
+
+/**
+ * Predicate of a subscription on the value its path selects.
+ */
+enum jsmn_sub_op {
+  JSMN_SUB_EXISTS = 0, /* any value */
+  JSMN_SUB_EQUALS = 1, /* the decoded string or the primitive equals value */
+  JSMN_SUB_PREFIX = 2  /* the decoded string or the primitive starts with it */
+};
+
+/**
+ * A subscription: a path in the syntax of jsmn_paths_compile() and a
+ * predicate. Its position in the subscription array is its bit in the
+ * match set.
+ */
+typedef struct {
+  const char *path;
+  enum jsmn_sub_op op;
+  const char *value;
+  size_t len;
+  int order; /* a slot of the match order, set by jsmn_subs_compile() */
+} jsmn_sub;
+
+/**
+ * Merge the paths of n subscriptions into the trie paths, so they can be
+ * matched together. The subscriptions ending at each trie node are laid
+ * out in the order fields as one run sorted by predicate and value.
+ * Return JSMN_ERROR_INVAL for a bad path and JSMN_ERROR_NOMEM if the trie
+ * storage is exhausted.
+ */
+JSMN_API enum jsmnerr jsmn_subs_compile(jsmn_paths *paths, jsmn_sub *subs,
+                                        const unsigned int n);
+
+/**
+ * Match the n subscriptions compiled into paths against a parsed document
+ * and set bit i of matched (an array of (n + 31) / 32 words) if subs[i]
+ * matches. A subscription matches if any value its path selects satisfies
+ * the predicate; array elements are visited by both [*] and their index
+ * paths. The token array is walked once and subtrees no path leads
+ * into are jumped over. On a value, the equality predicates of its path
+ * take one binary search and the prefix predicates one per distinct prefix
+ * length, so hundreds of filters on one field cost little more than one.
+ * Every JSMN_SUB_EXISTS subscription of the path is marked, as are strings
+ * whose escapes do not decode into 256 bytes, which are tested one
+ * subscription at a time.
+ */
+JSMN_API void jsmn_subs_match(const char *js, const jsmntok_t *tokens,
+                              const unsigned int num_tokens,
+                              const jsmn_paths *paths, const jsmn_sub *subs,
+                              const unsigned int n, uint32_t *matched);
+
+#ifndef JSMN_PREFILTER_MAX
+#define JSMN_PREFILTER_MAX 16
+#endif
+
+/**
+ * Raw-byte prefilter: needles that a record must contain before it is
+ * worth parsing, see jsmn_prefilter_init().
+ */
+typedef struct {
+  unsigned int n;
+  bool any; /* one needle suffices instead of all of them */
+  struct {
+    const char *s;
+    size_t len;
+  } needles[JSMN_PREFILTER_MAX];
+} jsmn_prefilter;
+
+/**
+ * Set up a prefilter for n NUL-terminated, non-empty needles, which are
+ * searched byte for byte. They should not span tokens, since whitespace
+ * between tokens is free: prefer "\"error\"" over "\"level\":\"error\"".
+ * With any set a record passes if it contains one of them, otherwise it
+ * must contain all. Return JSMN_ERROR_NOMEM for more than
+ * JSMN_PREFILTER_MAX needles and JSMN_ERROR_INVAL for an empty one.
+ */
+JSMN_API enum jsmnerr jsmn_prefilter_init(jsmn_prefilter *pf,
+                                          const char *const *needles,
+                                          const unsigned int n,
+                                          const bool any);
+
+/**
+ * Return false if the record js[0..len) cannot match. This is conservative:
+ * a record that misses a needle but contains a backslash passes, since an
+ * escape could spell the needle differently.
+ */
+JSMN_API bool jsmn_prefilter_match(const jsmn_prefilter *pf, const char *js,
+                                   const size_t len);
+
+/**
+ * Find the next record of the NDJSON buffer buf[0..len), starting at *pos,
+ * that passes the prefilter. Return true and its span in *start and *end
+ * (without the newline), or false at the end of the buffer. *pos is
+ * advanced past the record; rejected records cost only the scan.
+ */
+JSMN_API bool jsmn_prefilter_next(const jsmn_prefilter *pf, const char *buf,
+                                  const size_t len, size_t *pos,
+                                  size_t *start, size_t *end);
+
+/**
+ * Output sink: a caller buffer that is handed to flush whenever it fills
+ * up. flush returns 0 on success. Without flush, output that does not fit
+ * fails with JSMN_ERROR_NOMEM and buf holds what was written so far.
+ */
+typedef struct {
+  char *buf;
+  size_t cap;
+  size_t len;
+  int (*flush)(void *ctx, const char *data, size_t len);
+  void *ctx;
+} jsmn_sink;
+
+/**
+ * Set up a sink over buf[0..cap).
+ */
+JSMN_API void jsmn_sink_init(jsmn_sink *sink, char *buf, const size_t cap,
+                             int (*flush)(void *ctx, const char *data,
+                                          size_t len),
+                             void *ctx);
+
+/**
+ * Append n bytes. Writes that do not fit into an empty buffer go to flush
+ * directly.
+ */
+JSMN_API enum jsmnerr jsmn_sink_write(jsmn_sink *sink, const char *data,
+                                      const size_t n);
+
+/**
+ * Hand the buffered bytes to flush, if there is one.
+ */
+JSMN_API enum jsmnerr jsmn_sink_flush(jsmn_sink *sink);
+
+/**
+ * A rewrite: the value at path (in the syntax of jsmn_paths_compile()) is
+ * replaced by the JSON text value[0..len), e.g. "\"***\"".
+ */
+typedef struct {
+  const char *path;
+  const char *value;
+  size_t len;
+} jsmn_rewrite;
+
+/**
+ * Merge the paths of n rewrites into the trie paths. They are also marked
+ * as selected, so the same trie can drive a projection (parser->proj) that
+ * only tokenizes what jsmn_rewrite_run() needs, as long as no path has an
+ * index step: a projection drops the elements before it. Where paths
+ * repeat, the first rewrite wins.
+ */
+JSMN_API enum jsmnerr jsmn_rewrite_compile(jsmn_paths *paths,
+                                           const jsmn_rewrite *rules,
+                                           const unsigned int n);
+
+/**
+ * Write js[0..len) to out with the values selected by the compiled
+ * rewrites replaced. Bytes between replacements are copied verbatim and
+ * the document is not re-serialized. tokens must come from parsing js.
+ * The sink is not flushed at the end.
+ */
+JSMN_API enum jsmnerr jsmn_rewrite_run(const char *js, const size_t len,
+                                       const jsmntok_t *tokens,
+                                       const unsigned int num_tokens,
+                                       const jsmn_paths *paths,
+                                       const jsmn_rewrite *rules,
+                                       jsmn_sink *out);
+
+/* Buffer size that fits any number written by jsmn_format_*() */
+#define JSMN_FORMAT_MAX 32
+
+/**
+ * Write the shortest decimal that reads back as exactly v (Grisu3, with an
+ * exact fallback for the inputs it cannot decide) and return its length.
+ * The format is ECMAScript's: plain for 1e-7 < |v| < 1e21, otherwise with
+ * an exponent, as in 1e+21 or 1.5e-7. -0 is written as -0. NaN and
+ * infinities have no JSON form; nothing is written for them and 0 is
+ * returned. No NUL is appended.
+ */
+JSMN_API size_t jsmn_format_f64(char *buf, const double v);
+
+/**
+ * Write an integer in decimal and return its length. No NUL is appended.
+ */
+JSMN_API size_t jsmn_format_i64(char *buf, const int64_t v);
+JSMN_API size_t jsmn_format_u64(char *buf, uint64_t v);
+
+#define JSMN_WRITER_DEPTH 63
+
+/**
+ * JSON writer over a sink, see jsmn_writer_init().
+ */
+typedef struct {
+  jsmn_sink *sink;
+  unsigned int depth;
+  uint64_t objects;  /* bit d: the container at depth d is an object */
+  uint64_t nonempty; /* bit d: the container at depth d has members */
+  bool want_value;   /* a key was written, its value is next */
+  enum jsmnerr error; /* first error, later calls do nothing */
+} jsmn_writer;
+
+/**
+ * Set up a writer. Calls must form valid JSON: keys only in objects and
+ * every key followed by one value, with at most JSMN_WRITER_DEPTH levels
+ * of nesting. Top-level values are separated by newlines. A misplaced call
+ * fails with JSMN_ERROR_INVAL and a non-finite double with
+ * JSMN_ERROR_RANGE. The first error sticks and is returned by every later
+ * call, so it is enough to check jsmn_writer_finish().
+ */
+JSMN_API void jsmn_writer_init(jsmn_writer *w, jsmn_sink *sink);
+
+JSMN_API enum jsmnerr jsmn_writer_begin_object(jsmn_writer *w);
+JSMN_API enum jsmnerr jsmn_writer_end_object(jsmn_writer *w);
+JSMN_API enum jsmnerr jsmn_writer_begin_array(jsmn_writer *w);
+JSMN_API enum jsmnerr jsmn_writer_end_array(jsmn_writer *w);
+
+/**
+ * Write a key or a string value. Quotes, backslashes and control
+ * characters are escaped; other bytes, UTF-8 included, are copied as
+ * they are.
+ */
+JSMN_API enum jsmnerr jsmn_writer_key(jsmn_writer *w, const char *key,
+                                      const size_t len);
+JSMN_API enum jsmnerr jsmn_writer_string(jsmn_writer *w, const char *s,
+                                         const size_t len);
+
+/**
+ * Write a number. Doubles are written with the fewest digits that read
+ * back as the same value, in ECMAScript's format except that -0 stays -0.
+ */
+JSMN_API enum jsmnerr jsmn_writer_i64(jsmn_writer *w, const int64_t v);
+JSMN_API enum jsmnerr jsmn_writer_u64(jsmn_writer *w, const uint64_t v);
+JSMN_API enum jsmnerr jsmn_writer_f64(jsmn_writer *w, const double v);
+JSMN_API enum jsmnerr jsmn_writer_bool(jsmn_writer *w, const bool v);
+JSMN_API enum jsmnerr jsmn_writer_null(jsmn_writer *w);
+
+/**
+ * Copy a parsed token from js verbatim: a key, or a value together with
+ * everything inside it. Containers need their end offset, so an unclosed
+ * one fails with JSMN_ERROR_INVAL.
+ */
+JSMN_API enum jsmnerr jsmn_writer_token(jsmn_writer *w, const char *js,
+                                        const jsmntok_t *tok);
+
+/**
+ * Check that every container was closed and flush the sink.
+ */
+JSMN_API enum jsmnerr jsmn_writer_finish(jsmn_writer *w);
+
+/**
+ * Remove all whitespace outside strings from js[0..len) into out, which
+ * needs len bytes and may be js itself, and store the new length in
+ * outlen. The input is not validated; an unterminated string is copied as
+ * it is and JSMN_ERROR_UNCLOSED_STRING returned.
+ */
+JSMN_API enum jsmnerr jsmn_minify(const char *js, const size_t len,
+                                  char *out, size_t *outlen);
+
+/**
+ * Write js[0..len) to out with one member or element per line, nested
+ * lines prefixed by one copy of indent (e.g. "  " or "\t") per level and
+ * a space after colons. Empty containers stay on one line and top-level
+ * values are separated by newlines. Like jsmn_minify() this works on the
+ * bytes and does not validate. The sink is not flushed at the end.
+ */
+JSMN_API enum jsmnerr jsmn_prettify(const char *js, const size_t len,
+                                    jsmn_sink *out, const char *indent);
+
+/**
+ * Return the number of tokens jsmn_parse() emits for js[0..len), counted
+ * in one pass over the bytes, so that a token array can be allocated
+ * before parsing. Exact for valid JSON without projection or shallow
+ * parsing, which only emit fewer.
+ */
+JSMN_API size_t jsmn_count_tokens(const char *js, const size_t len);
+
+/**
+ * One segment of scattered input, laid out like struct iovec.
+ */
+typedef struct {
+  const void *base;
+  size_t len;
+} jsmn_iovec;
+
+/**
+ * Parse the concatenation of n segments without copying it. Token offsets
+ * refer to the concatenation, and strings and primitives spanning segments
+ * get the split flag. A string or primitive cut by a segment boundary is
+ * parsed from scratch[0..scratchcap), which must hold it together with any
+ * whitespace before the next token; JSMN_ERROR_NOMEM is returned if it does
+ * not. The other results are those of jsmn_parse(), with budgets counted
+ * over the whole call, and like it jsmn_parse_iov() can be called again
+ * with more segments appended. Projection, required keys, shallow parsing
+ * and the shape cache need contiguous input and are rejected with
+ * JSMN_ERROR_INVAL.
+ */
+JSMN_API enum jsmnerr jsmn_parse_iov(jsmn_parser *parser,
+                                     const jsmn_iovec *iov, const unsigned int n,
+                                     jsmntok_t *tokens,
+                                     const unsigned int num_tokens,
+                                     char *scratch, const size_t scratchcap);
+
+/**
+ * Return a pointer to the bytes js[start..end) of tok in the segments:
+ * into its segment if it lies within one, otherwise gathered into
+ * out[0..cap). Return NULL if a spanning token does not fit into out.
+ */
+JSMN_API const char *jsmn_iov_span(const jsmn_iovec *iov, const unsigned int n,
+                                   const jsmntok_t *tok, char *out,
+                                   const size_t cap);
+
+/**
+ * Drop the first n tokens and the first skip bytes of input, so that a
+ * parser reading an endless stream of documents keeps its offsets and
+ * token count bounded. The dropped tokens must be whole top-level values
+ * and no other token may start before skip. The remaining tokens move to
+ * the front of the array, all offsets go down by skip, and parsing goes on
+ * with the input from skip on. Returns JSMN_ERROR_INVAL if the state does
+ * not allow it, or with projection, required keys or the shape cache.
+ */
+JSMN_API enum jsmnerr jsmn_discard(jsmn_parser *parser, jsmntok_t *tokens,
+                                   const unsigned int n, const size_t skip);
+
+#ifdef JSMN_SYMTAB
+/**
+ * Initialize a symbol table with nslots slots (a power of two) and namecap
+ * bytes of name storage. At most 3/4 of the slots are used.
+ */
+JSMN_API void jsmn_symtab_init(jsmn_symtab *symtab, jsmn_sym *slots,
+                               const unsigned int nslots, char *names,
+                               const size_t namecap);
+
+/**
+ * Return the id of name, interning it first if needed. Return
+ * JSMN_SYM_UNKNOWN if the table or the name buffer is full.
+ */
+JSMN_API int jsmn_symtab_add(jsmn_symtab *symtab, const char *name,
+                             const size_t len);
+
+/**
+ * Return the id of name, or JSMN_SYM_UNKNOWN if it was never interned.
+ */
+JSMN_API int jsmn_symtab_find(jsmn_symtab *symtab, const char *name,
+                              const size_t len);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
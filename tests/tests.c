@@ -1,3 +1,4 @@
+#include <math.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
@@ -91,6 +92,133 @@ int test_string(void) {
   return 0;
 }
 
+int test_string_escapes(void) {
+  jsmn_parser p;
+  jsmntok_t t[8];
+  const char *js = "{\"a\\\"b\": \"plain\", \"c\": [\"\\u00e9\", \"x\\\\\"]}";
+
+  jsmn_init(&p);
+  check(jsmn_parse(&p, js, strlen(js), t, 8) == JSMN_SUCCESS);
+  check(t[1].type == JSMN_STRING && t[1].has_escapes);
+  check(t[2].type == JSMN_STRING && !t[2].has_escapes);
+  check(t[3].type == JSMN_STRING && !t[3].has_escapes);
+  check(t[5].type == JSMN_STRING && t[5].has_escapes);
+  check(t[6].type == JSMN_STRING && t[6].has_escapes);
+  check(!t[0].has_escapes && !t[4].has_escapes);
+  return 0;
+}
+
+int test_unescape(void) {
+  jsmn_parser p;
+  jsmntok_t t[8];
+  char buf[64];
+  size_t n;
+  const char *js = "[\"plain text\", \"a\\nb\\t\\\"c\\\"\\\\\\/\", "
+                   "\"\\u00e9\\u20AC\\ud83d\\ude00!\", \"\\ud83d\", "
+                   "\"\\udE00x\", \"embedded {\\\"k\\\": \\\"v\\\"}\"]";
+
+  jsmn_init(&p);
+  check(jsmn_parse(&p, js, strlen(js), t, 8) == JSMN_SUCCESS);
+  check(jsmn_unescape(js, &t[1], buf, sizeof(buf), &n) == JSMN_SUCCESS);
+  check(n == 10 && memcmp(buf, "plain text", n) == 0);
+  check(jsmn_unescape(js, &t[2], NULL, 0, &n) == JSMN_SUCCESS && n == 9);
+  check(jsmn_unescape(js, &t[2], buf, sizeof(buf), &n) == JSMN_SUCCESS);
+  check(n == 9 && memcmp(buf, "a\nb\t\"c\"\\/", n) == 0);
+  check(jsmn_unescape(js, &t[3], buf, sizeof(buf), &n) == JSMN_SUCCESS);
+  check(n == 10 &&
+        memcmp(buf, "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80!", n) == 0);
+  check(jsmn_unescape(js, &t[3], buf, 9, &n) == JSMN_ERROR_NOMEM && n == 10);
+  check(jsmn_unescape(js, &t[4], buf, sizeof(buf), &n) == JSMN_ERROR_INVAL);
+  check(jsmn_unescape(js, &t[5], buf, sizeof(buf), &n) == JSMN_ERROR_INVAL);
+  check(jsmn_unescape(js, &t[6], buf, sizeof(buf), &n) == JSMN_SUCCESS);
+  check(n == 19 && memcmp(buf, "embedded {\"k\": \"v\"}", n) == 0);
+  check(jsmn_unescape(js, &t[0], buf, sizeof(buf), &n) == JSMN_ERROR_INVAL);
+  return 0;
+}
+
+int test_insitu(void) {
+  jsmn_parser p;
+  jsmntok_t t[10];
+  char js[] = "{\"a\\nb\": [1, true,null], \"k\":\"\\u00e9x\\\"\",\"z\":-2}";
+
+  jsmn_init(&p);
+  check(jsmn_parse_insitu(&p, js, strlen(js), t, 4) == JSMN_ERROR_NOMEM);
+  check(jsmn_parse_insitu(&p, js, sizeof(js) - 1, t, 10) == JSMN_SUCCESS);
+  check(p.toknext == 10);
+  check(t[1].size == 3 && strcmp(js + t[1].start, "a\nb") == 0);
+  check(!t[1].has_escapes);
+  check(t[2].type == JSMN_ARRAY && t[2].size == 3);
+  check(strcmp(js + t[3].start, "1") == 0);
+  check(strcmp(js + t[4].start, "true") == 0);
+  check(strcmp(js + t[5].start, "null") == 0);
+  check(t[7].size == 4 && strcmp(js + t[7].start, "\xc3\xa9x\"") == 0);
+  check(strcmp(js + t[8].start, "z") == 0);
+  check(strcmp(js + t[9].start, "-2") == 0);
+
+  /* Fed in pieces, a string or primitive cut by the end of the buffer is
+   * left as is and scanned again */
+  {
+    char buf[] =
+        "{\"a\\nb\": [1, true,null], \"k\":\"\\u00e9x\\\"\",\"z\":-2}";
+    size_t n;
+
+    jsmn_init(&p);
+    for (n = 1; n < sizeof(buf); n++)
+      check((jsmn_parse_insitu(&p, buf, n, t, 10) == JSMN_SUCCESS) ==
+            (n == sizeof(buf) - 1));
+    check(p.toknext == 10);
+    check(t[0].size == 3 && t[2].size == 3);
+    check(strcmp(buf + t[1].start, "a\nb") == 0);
+    check(strcmp(buf + t[7].start, "\xc3\xa9x\"") == 0);
+    check(strcmp(buf + t[9].start, "-2") == 0);
+  }
+
+  /* A lone surrogate cannot be decoded to UTF-8 */
+  {
+    char buf[] = "{\"k\": \"\\ud83d\"}";
+
+    jsmn_init(&p);
+    check(jsmn_parse_insitu(&p, buf, sizeof(buf) - 1, t, 10) ==
+          JSMN_ERROR_INVALID_UTF8);
+  }
+  return 0;
+}
+
+static enum jsmnerr parse_flags(const char *js, unsigned int flags) {
+  jsmn_parser p;
+  jsmntok_t t[8];
+
+  jsmn_init(&p);
+  p.flags = flags;
+  return jsmn_parse(&p, js, strlen(js), t, 8);
+}
+
+int test_utf8(void) {
+  const unsigned int f = JSMN_VALIDATE_UTF8;
+
+  check(parse_flags("{\"k\": \"h\xc3\xa9llo \xe2\x82\xac, a longer ascii run "
+                    "\xf0\x9f\x98\x80\"}",
+                    f) == JSMN_SUCCESS);
+  check(parse_flags("{\"k\": \"\\ud83d\\ude00\"}", f) == JSMN_SUCCESS);
+  check(parse_flags("{\"k\": \"\xc3\x28\"}", f) == JSMN_ERROR_INVALID_UTF8);
+  check(parse_flags("{\"k\": \"\xc0\xaf\"}", f) == JSMN_ERROR_INVALID_UTF8);
+  check(parse_flags("{\"k\": \"\xed\xa0\x80\"}", f) ==
+        JSMN_ERROR_INVALID_UTF8);
+  check(parse_flags("{\"k\": \"\xf4\x90\x80\x80\"}", f) ==
+        JSMN_ERROR_INVALID_UTF8);
+  check(parse_flags("{\"k\": \"abcdefghijkl\x80\"}", f) ==
+        JSMN_ERROR_INVALID_UTF8);
+  check(parse_flags("{\"k\": \"\\ud83dx\"}", f) == JSMN_ERROR_INVALID_UTF8);
+  check(parse_flags("{\"k\": \"\\ude00\"}", f) == JSMN_ERROR_INVALID_UTF8);
+  check(parse_flags("{\"k\": \"\\ud83d\\u0041\"}", f) ==
+        JSMN_ERROR_INVALID_UTF8);
+  check(parse_flags("{\"k\": \"\xe2\x82", f) == JSMN_ERROR_UNCLOSED_STRING);
+  check(parse_flags("{\"k\": \"\\ud83d", f) == JSMN_ERROR_UNCLOSED_STRING);
+  /* Not validated by default */
+  check(parse_flags("{\"k\": \"\xc3\x28\\ude00\"}", 0) == JSMN_SUCCESS);
+  return 0;
+}
+
 int test_partial_string(void) {
   int r;
   unsigned long i;
@@ -266,12 +394,1210 @@ int test_bad_assignment(void) {
   return 0;
 }
 
+int test_number_int(void) {
+  jsmn_parser p;
+  jsmntok_t t[16];
+  int64_t i;
+  uint64_t u;
+  const char *js = "[0, -0, 42, -9223372036854775808, 9223372036854775807, "
+                   "9223372036854775808, 18446744073709551615, "
+                   "18446744073709551616, 1.5, 1e3, true, \"7\", 012, -]";
+
+  jsmn_init(&p);
+  check(jsmn_parse(&p, js, strlen(js), t, 16) == JSMN_SUCCESS);
+  check(jsmn_get_i64(js, &t[1], &i) == JSMN_SUCCESS && i == 0);
+  check(jsmn_get_u64(js, &t[2], &u) == JSMN_SUCCESS && u == 0);
+  check(jsmn_get_i64(js, &t[3], &i) == JSMN_SUCCESS && i == 42);
+  check(jsmn_get_i64(js, &t[4], &i) == JSMN_SUCCESS && i == INT64_MIN);
+  check(jsmn_get_u64(js, &t[4], &u) == JSMN_ERROR_RANGE);
+  check(jsmn_get_i64(js, &t[5], &i) == JSMN_SUCCESS && i == INT64_MAX);
+  check(jsmn_get_i64(js, &t[6], &i) == JSMN_ERROR_RANGE);
+  check(jsmn_get_u64(js, &t[6], &u) == JSMN_SUCCESS &&
+        u == 9223372036854775808ULL);
+  check(jsmn_get_u64(js, &t[7], &u) == JSMN_SUCCESS && u == UINT64_MAX);
+  check(jsmn_get_u64(js, &t[8], &u) == JSMN_ERROR_RANGE);
+  check(jsmn_get_i64(js, &t[9], &i) == JSMN_ERROR_NOT_INTEGER);
+  check(jsmn_get_u64(js, &t[10], &u) == JSMN_ERROR_NOT_INTEGER);
+  check(jsmn_get_i64(js, &t[11], &i) == JSMN_ERROR_NOT_NUMBER);
+  check(jsmn_get_i64(js, &t[12], &i) == JSMN_ERROR_NOT_NUMBER);
+  check(jsmn_get_i64(js, &t[13], &i) == JSMN_ERROR_NOT_NUMBER);
+  check(jsmn_get_i64(js, &t[14], &i) == JSMN_ERROR_NOT_NUMBER);
+  return 0;
+}
+
+/* 2^-1075, exactly half of the smallest denormal */
+#define HALF_DENORMAL                                                          \
+  "2.4703282292062327208828439643411068618252990130716238221279284125"         \
+  "033775363510437593264991818081799618989828234772285886546332835517"         \
+  "796989819938739800539093906315035659515570226392290858392449105184"         \
+  "435931802849936536152500319370457678249219365623669863658480757001"         \
+  "585769269903706311928279558551332927834338409351978015531246597263"         \
+  "579574622766465272827220056374006485499977096599470454020828166226"         \
+  "237857393450736339007967761930577506740176324673600968951340535537"         \
+  "458516661134223766678604162159680461914467291840300530057530849048"         \
+  "765391711386591646239524912623653881879636239373280423891018672348"         \
+  "497668235089863388587925628302755995657524455507255189313690836254"         \
+  "779186948667994968324049705821028513185451396213837722826145437693"         \
+  "412532098591327667236328125"
+
+int test_number_float(void) {
+  jsmn_parser p;
+  jsmntok_t t[24];
+  double d;
+  const char *js =
+      "[0.1, -0.0, 1e23, 2.2250738585072011e-308, 4.9e-324, "
+      "1.7976931348623157e308, 9007199254740993, "
+      "0.1000000000000000055511151231257827021181583404541015625, "
+      HALF_DENORMAL "e-324, " HALF_DENORMAL "1e-324, "
+      "1e-400, 1e309, -1e309, 1., -.5, 1e, 1E+2, 123456789012345678901234]";
+
+  jsmn_init(&p);
+  check(jsmn_parse(&p, js, strlen(js), t, 24) == JSMN_SUCCESS);
+  check(jsmn_get_f64(js, &t[1], &d) == JSMN_SUCCESS && d == 0.1);
+  check(jsmn_get_f64(js, &t[2], &d) == JSMN_SUCCESS && d == 0 &&
+        signbit(d));
+  check(jsmn_get_f64(js, &t[3], &d) == JSMN_SUCCESS && d == 1e23);
+  check(jsmn_get_f64(js, &t[4], &d) == JSMN_SUCCESS &&
+        d == 2.2250738585072011e-308);
+  check(jsmn_get_f64(js, &t[5], &d) == JSMN_SUCCESS && d == 4.9e-324);
+  check(jsmn_get_f64(js, &t[6], &d) == JSMN_SUCCESS &&
+        d == 1.7976931348623157e308);
+  check(jsmn_get_f64(js, &t[7], &d) == JSMN_SUCCESS &&
+        d == 9007199254740992.0);
+  check(jsmn_get_f64(js, &t[8], &d) == JSMN_SUCCESS && d == 0.1);
+  /* Ties to even, anything above rounds up */
+  check(jsmn_get_f64(js, &t[9], &d) == JSMN_SUCCESS && d == 0);
+  check(jsmn_get_f64(js, &t[10], &d) == JSMN_SUCCESS && d == 4.9e-324);
+  check(jsmn_get_f64(js, &t[11], &d) == JSMN_SUCCESS && d == 0);
+  check(jsmn_get_f64(js, &t[12], &d) == JSMN_ERROR_RANGE && isinf(d) &&
+        d > 0);
+  check(jsmn_get_f64(js, &t[13], &d) == JSMN_ERROR_RANGE && isinf(d) &&
+        d < 0);
+  check(jsmn_get_f64(js, &t[14], &d) == JSMN_ERROR_NOT_NUMBER);
+  check(jsmn_get_f64(js, &t[15], &d) == JSMN_ERROR_NOT_NUMBER);
+  check(jsmn_get_f64(js, &t[16], &d) == JSMN_ERROR_NOT_NUMBER);
+  check(jsmn_get_f64(js, &t[17], &d) == JSMN_SUCCESS && d == 100);
+  check(jsmn_get_f64(js, &t[18], &d) == JSMN_SUCCESS &&
+        d == 123456789012345678901234.0);
+  return 0;
+}
+
+int test_number_array(void) {
+  jsmn_parser p;
+  jsmntok_t t[32];
+  double d[8];
+  int64_t v[8];
+  size_t n;
+  const char *js = "{\"a\": [1, 2.5, -3e2], \"m\": [[1, 2, 3], [4, 5, 6]], "
+                   "\"r\": [[1, 2], [3]], \"s\": [1, \"2\"], \"e\": []}";
+
+  jsmn_init(&p);
+  check(jsmn_parse(&p, js, strlen(js), t, 32) == JSMN_SUCCESS);
+  check(jsmn_array_to_f64(js, t, p.toknext, 2, d, 8, &n) == JSMN_SUCCESS);
+  check(n == 3 && d[0] == 1 && d[1] == 2.5 && d[2] == -300);
+  check(jsmn_array_to_i64(js, t, p.toknext, 2, v, 8, &n) ==
+        JSMN_ERROR_NOT_INTEGER);
+  check(jsmn_array_to_i64(js, t, p.toknext, 7, v, 8, &n) == JSMN_SUCCESS);
+  check(n == 6 && v[0] == 1 && v[2] == 3 && v[3] == 4 && v[5] == 6);
+  check(jsmn_array_to_i64(js, t, p.toknext, 7, v, 5, &n) == JSMN_ERROR_NOMEM &&
+        n == 6);
+  check(jsmn_array_to_f64(js, t, p.toknext, 17, d, 8, &n) == JSMN_ERROR_SHAPE);
+  check(jsmn_array_to_f64(js, t, p.toknext, 24, d, 8, &n) ==
+        JSMN_ERROR_NOT_NUMBER);
+  check(jsmn_array_to_f64(js, t, p.toknext, 28, d, 8, &n) == JSMN_SUCCESS &&
+        n == 0);
+  check(jsmn_array_to_f64(js, t, p.toknext, 0, d, 8, &n) == JSMN_ERROR_SHAPE);
+  return 0;
+}
+
+int test_object_get(void) {
+  jsmn_parser p;
+  jsmntok_t tok[256];
+  jsmn_index_slot slots[128];
+  jsmn_index index;
+  char js[2048];
+  char key[16];
+  size_t n = 0;
+  int i, v, r;
+
+  const char *small = "{\"a\": 1, \"b\": [1, {\"a\": 2}], \"c\": {\"d\": 3}, "
+                      "\"\\u0065\": 4, \"a\": 5}";
+  jsmn_init(&p);
+  r = jsmn_parse(&p, small, strlen(small), tok, 32);
+  check(r == JSMN_SUCCESS);
+  check(jsmn_object_get(small, tok, p.toknext, 0, "a", 1, NULL) == 2);
+  v = jsmn_object_get(small, tok, p.toknext, 0, "c", 1, NULL);
+  check(v == 10);
+  check(jsmn_object_get(small, tok, p.toknext, v, "d", 1, NULL) == 12);
+  check(jsmn_object_get(small, tok, p.toknext, 0, "d", 1, NULL) == -1);
+  check(jsmn_object_get(small, tok, p.toknext, 0, "e", 1, NULL) == 14);
+  check(jsmn_object_get(small, tok, p.toknext, 3, "a", 1, NULL) == -1);
+
+  /* Large object: the index must agree with the linear search */
+  n += sprintf(js + n, "{");
+  for (i = 0; i < 40; i++)
+    n += sprintf(js + n, "%s\"k%d\": %s", i ? ", " : "", i,
+                 i % 3 ? "[1, {\"x\": 0}]" : "7");
+  n += sprintf(js + n, ", \"k\\u0031x\": 1, \"k3\": 2}");
+  jsmn_init(&p);
+  r = jsmn_parse(&p, js, n, tok, 256);
+  check(r == JSMN_SUCCESS);
+  check(tok[0].size == 42);
+
+  jsmn_index_init(&index, slots, 128);
+  check(jsmn_object_get(js, tok, p.toknext, 0, "k1x", 3, &index) > 0);
+  check(index.nobjs == 1 && index.used == 128);
+  for (i = 0; i < 42; i++) {
+    const int len = sprintf(key, i < 40 ? "k%d" : "missing%d", i);
+    v = jsmn_object_get(js, tok, p.toknext, 0, key, len, &index);
+    check(v == jsmn_object_get(js, tok, p.toknext, 0, key, len, NULL));
+    check((v > 0) == (i < 40));
+    if (v > 0)
+      check(tok[v - 1].size == len &&
+            memcmp(js + tok[v - 1].start, key, len) == 0);
+  }
+  v = jsmn_object_get(js, tok, p.toknext, 0, "k3", 2, &index);
+  check(tok[v].type == JSMN_PRIMITIVE && js[tok[v].start] == '7');
+
+  /* An arena that is too small falls back to the linear search */
+  jsmn_index_init(&index, slots, 64);
+  v = jsmn_object_get(js, tok, p.toknext, 0, "k39", 3, &index);
+  check(v > 0 && index.nobjs == 0);
+  check(v == jsmn_object_get(js, tok, p.toknext, 0, "k39", 3, NULL));
+  return 0;
+}
+
+static int same_tokens(const jsmntok_t *a, const jsmntok_t *b, int n) {
+  int i;
+  for (i = 0; i < n; i++) {
+    if (a[i].type != b[i].type || a[i].start != b[i].start ||
+        a[i].size != b[i].size || a[i].is_key != b[i].is_key ||
+        a[i].has_escapes != b[i].has_escapes)
+      return 0;
+  }
+  return 1;
+}
+
+int test_shape_cache(void) {
+  const char *records[] = {
+      "{\"id\": 1, \"user\": {\"name\": \"a\", \"age\": 3}, \"tags\": [{\"k\": 1}]}",
+      "{\"id\": 2, \"user\": {\"name\": \"b\", \"age\": 4}, \"tags\": [{\"k\": 2}]}",
+      "{\"id\": 3, \"user\": {\"name\": \"c\", \"age\": 5}, \"tags\": []}",
+      "{\"id\": 4, \"user\": {\"name\": \"d\"}, \"t\\u0061gs\": [{\"k\": 3}]}",
+      "{\"id\": 5, \"user\": {\"name\": \"e\"}, \"t\\u0061gs\": [{\"k\": 4}]}",
+      "{\"ids\": 6, \"user\": {\"age\": 1, \"name\": \"f\"}}",
+      "{\"ids\": 7, \"user\": {\"age\": 1, \"name\": \"f\"}, \"x\": {\"id\": 0}}",
+  };
+  jsmn_shape shapes[8];
+  jsmn_shape_cache cache;
+  jsmn_parser p;
+  jsmntok_t tok[32], ref[32];
+  unsigned long hits;
+  int i, r;
+
+  jsmn_shape_init(&cache, shapes, 8);
+  for (i = 0; i < (int)(sizeof(records) / sizeof(records[0])); i++) {
+    const char *js = records[i];
+    jsmn_init(&p);
+    r = jsmn_parse(&p, js, strlen(js), ref, 32);
+    check(r == JSMN_SUCCESS);
+    hits = cache.hits;
+    jsmn_init(&p);
+    p.shapes = &cache;
+    r = jsmn_parse(&p, js, strlen(js), tok, 32);
+    check(r == JSMN_SUCCESS);
+    check(p.depth == 0);
+    check(same_tokens(tok, ref, p.toknext));
+    switch (i) {
+    case 1: /* same shape */
+      check(cache.hits - hits == 6);
+      break;
+    case 4: /* same shape with an escaped key */
+      check(cache.hits - hits == 5 && tok[7].has_escapes);
+      break;
+    case 5: /* new keys and order */
+      check(cache.hits - hits == 0);
+      break;
+    case 6: /* an extra key */
+      check(cache.hits - hits == 4);
+      break;
+    }
+  }
+
+  /* Keys split by the end of the buffer are scanned after all */
+  jsmn_init(&p);
+  p.shapes = &cache;
+  r = jsmn_parse(&p, records[6], 6, tok, 32);
+  check(r == JSMN_ERROR_UNCLOSED_STRING || r == JSMN_ERROR_UNCLOSED_OBJECT);
+  r = jsmn_parse(&p, records[6], strlen(records[6]), tok, 32);
+  check(r == JSMN_SUCCESS && tok[1].size == 3);
+  return 0;
+}
+
+int test_projection(void) {
+  const char *js =
+      "{\"id\": 7, \"user\": {\"id\": 1, \"name\": \"x\", \"tags\": [1, 2]},\n"
+      " \"events\": [{\"ts\": 1, \"x\": {\"a\": [1]}}, 5, {\"y\": 2},\n"
+      "            {\"ts\": \"t\\\"}\"}],\n"
+      " \"skip\": {\"deep\": [{\"a\": \"}]\"}]}, \"matrix\": [[1, 2, 3], [4, 5, 6]],\n"
+      " \"last\": 0}";
+  const char *list[] = {"user.id", "events[*].ts", "matrix[1][2]", "id"};
+  const char *bad[] = {"", "a..b", ".a", "a[", "a[x]", "a[1]b", "a.[1]"};
+  const char *broken[] = {"{\"events\": [}", "{\"events\": [1 }",
+                          "{\"events\": [{\"ts\":1}}", "{\"events\": [1, :]}",
+                          "{\"other\": [}", "{\"other\": }",
+                          "{\"other\": [1}]}"};
+  jsmn_path_node nodes[16];
+  jsmn_path_edge edges[16];
+  jsmn_paths paths;
+  jsmn_projection proj;
+  jsmn_parser p;
+  jsmntok_t tok[32];
+  size_t n;
+  int i, r;
+
+  jsmn_paths_init(&paths, nodes, 16, edges, 16);
+  for (i = 0; i < (int)(sizeof(bad) / sizeof(bad[0])); i++)
+    check(jsmn_paths_compile(&paths, &bad[i], 1) == JSMN_ERROR_INVAL);
+  check(paths.nnodes == 1);
+  check(jsmn_paths_compile(&paths, list, 4) == JSMN_SUCCESS);
+  check(paths.nnodes == 10 && paths.nedges == 9);
+
+  jsmn_init(&p);
+  jsmn_projection_init(&proj, &paths);
+  p.proj = &proj;
+  r = jsmn_parse(&p, js, strlen(js), tok, 32);
+  check(r == JSMN_SUCCESS);
+  check(p.toknext == 20);
+  check(tokeq(js, tok, 20, JSMN_OBJECT, -1, 4, JSMN_STRING, "id", 2,
+              JSMN_PRIMITIVE, "7", JSMN_STRING, "user", 4, JSMN_OBJECT, -1, 1,
+              JSMN_STRING, "id", 2, JSMN_PRIMITIVE, "1", JSMN_STRING,
+              "events", 6, JSMN_ARRAY, -1, 3, JSMN_OBJECT, -1, 1, JSMN_STRING,
+              "ts", 2, JSMN_PRIMITIVE, "1", JSMN_OBJECT, -1, 0, JSMN_OBJECT,
+              -1, 1, JSMN_STRING, "ts", 2, JSMN_STRING, "t\\\"}", 4,
+              JSMN_STRING, "matrix", 6, JSMN_ARRAY, -1, 1, JSMN_ARRAY, -1, 1,
+              JSMN_PRIMITIVE, "6"));
+  check(p.line == 5);
+  check(jsmn_object_get(js, tok, p.toknext, 0, "matrix", 6, NULL) == 17);
+
+  /* Fed in pieces, skipped values cut by the end of the buffer are
+   * picked up by the next call */
+  jsmn_init(&p);
+  jsmn_projection_init(&proj, &paths);
+  p.proj = &proj;
+  for (n = 1; n <= strlen(js); n++) {
+    r = jsmn_parse(&p, js, n, tok, 32);
+    check(n == strlen(js) ? r == JSMN_SUCCESS : r != JSMN_SUCCESS);
+  }
+  check(p.toknext == 20 && tok[8].size == 3);
+  check(tok[19].start == (size_t)(strstr(js, "6]]") - js));
+
+  /* Malformed input skipped by the projection fails as without it */
+  for (i = 0; i < (int)(sizeof(broken) / sizeof(broken[0])); i++) {
+    jsmn_init(&p);
+    jsmn_projection_init(&proj, &paths);
+    p.proj = &proj;
+    check(jsmn_parse(&p, broken[i], strlen(broken[i]), tok, 32) ==
+          JSMN_ERROR_UNEXPECTED_CHAR);
+  }
+
+  /* In-situ, a skipped key is left intact for the next call to scan */
+  {
+    char buf[] = "{\"skip\": [1, 2, 3], \"i\\u0064\": 5}";
+    const char *id[] = {"id"};
+
+    jsmn_paths_init(&paths, nodes, 16, edges, 16);
+    check(jsmn_paths_compile(&paths, id, 1) == JSMN_SUCCESS);
+    jsmn_init(&p);
+    jsmn_projection_init(&proj, &paths);
+    p.proj = &proj;
+    for (n = 1; n < sizeof(buf); n++) {
+      r = jsmn_parse_insitu(&p, buf, n, tok, 32);
+      check(n == sizeof(buf) - 1 ? r == JSMN_SUCCESS : r != JSMN_SUCCESS);
+    }
+    check(p.toknext == 3 && tok[0].size == 1);
+    check(strcmp(buf + tok[1].start, "id") == 0 && tok[1].size == 2);
+    check(strcmp(buf + tok[2].start, "5") == 0);
+    check(strncmp(buf, "{\"skip\": [1, 2, 3], ", 19) == 0);
+  }
+  return 0;
+}
+
+int test_early_exit(void) {
+  const char *js = "{\"ver\": 1, \"meta\": {\"type\": 0}, \"type\": \"put\", "
+                   "\"tenant\": {\"id\": [1, 2]}, \"body\": [1, 2, 3]}";
+  const char *broken = "{\"tenant\": 7, \"type\": \"get\", \"body\": [1, }";
+  const char *keys[] = {"type", "tenant"};
+  jsmn_required req;
+  jsmn_parser p;
+  jsmntok_t tok[32];
+  int r;
+
+  jsmn_init(&p);
+  jsmn_required_init(&req, keys, 2);
+  p.required = &req;
+  r = jsmn_parse(&p, js, strlen(js), tok, 32);
+  check(r == JSMN_EARLY_EXIT);
+  check(p.toknext == 15 && tok[0].size == 4);
+  check(tok[14].type == JSMN_PRIMITIVE && js[p.pos] == ',');
+  check(req.found == 3);
+
+  /* The rest can still be parsed */
+  p.required = NULL;
+  r = jsmn_parse(&p, js, strlen(js), tok, 32);
+  check(r == JSMN_SUCCESS && p.toknext == 20 && tok[0].size == 5);
+
+  /* Nothing after the last required value is looked at */
+  jsmn_init(&p);
+  jsmn_required_init(&req, keys, 2);
+  p.required = &req;
+  r = jsmn_parse(&p, broken, strlen(broken), tok, 32);
+  check(r == JSMN_EARLY_EXIT && p.toknext == 5);
+
+  /* Missing keys: the whole document is parsed */
+  jsmn_init(&p);
+  jsmn_required_init(&req, keys + 1, 1);
+  p.required = &req;
+  r = jsmn_parse(&p, "{\"type\": 1}", 11, tok, 32);
+  check(r == JSMN_SUCCESS && req.found == 0);
+  return 0;
+}
+
+int test_shallow(void) {
+  const char *js = "{\"id\": 1, \"payload\": {\"a\": [1, {\"b\": \"]}\"}], "
+                   "\"c\": \"x\"}, \"list\": [[1], [2]]}";
+  jsmn_parser p, sub;
+  jsmntok_t tok[16], subtok[16];
+  size_t n;
+  int r;
+
+  jsmn_init(&p);
+  p.shallow = 1;
+  r = jsmn_parse(&p, js, strlen(js), tok, 16);
+  check(r == JSMN_SUCCESS);
+  check(tokeq(js, tok, 7, JSMN_OBJECT, 0, 3, JSMN_STRING, "id", 2,
+              JSMN_PRIMITIVE, "1", JSMN_STRING, "payload", 7, JSMN_OBJECT, 21,
+              0, JSMN_STRING, "list", 4, JSMN_ARRAY, 64, 0));
+  check(tok[4].opaque && tok[6].opaque && !tok[0].opaque);
+  check(tok[4].end - tok[4].start == 33 && tok[6].end - tok[6].start == 10);
+
+  jsmn_init(&sub);
+  r = jsmn_expand(&sub, js, &tok[4], subtok, 16);
+  check(r == JSMN_SUCCESS && sub.toknext == 9);
+  check(tokeq(js, subtok, 9, JSMN_OBJECT, 21, 2, JSMN_STRING, "a", 1,
+              JSMN_ARRAY, 27, 2, JSMN_PRIMITIVE, "1", JSMN_OBJECT, 31, 1,
+              JSMN_STRING, "b", 1, JSMN_STRING, "]}", 2, JSMN_STRING, "c", 1,
+              JSMN_STRING, "x", 1));
+
+  /* Expansion can be shallow again, and arrays are fine as roots */
+  jsmn_init(&sub);
+  sub.shallow = 1;
+  r = jsmn_expand(&sub, js, &tok[6], subtok, 16);
+  check(r == JSMN_SUCCESS && sub.toknext == 3);
+  check(subtok[0].type == JSMN_ARRAY && subtok[0].size == 2);
+  check(subtok[1].opaque && subtok[1].size == 0);
+  check(subtok[1].end - subtok[1].start == 3);
+  jsmn_init(&sub);
+  check(jsmn_expand(&sub, js, &tok[0], subtok, 16) == JSMN_ERROR_INVAL);
+
+  /* An opaque span cut by the end of the buffer is picked up again */
+  jsmn_init(&p);
+  p.shallow = 1;
+  for (n = 1; n <= strlen(js); n++) {
+    r = jsmn_parse(&p, js, n, tok, 16);
+    check(n == strlen(js) ? r == JSMN_SUCCESS : r != JSMN_SUCCESS);
+  }
+  check(p.toknext == 7 && tok[4].end - tok[4].start == 33 &&
+        tok[6].end - tok[6].start == 10);
+
+  /* Lookups step over opaque values, but cannot look into them */
+  {
+    const char *doc = "{\"payload\": {\"id\": 0, \"b\": [1, 2]}, \"id\": 1, "
+                      "\"x\": {\"id\": 2}, \"m\": [[1, 2], [3, 4]]}";
+    int64_t v[4];
+
+    jsmn_init(&p);
+    p.shallow = 1;
+    r = jsmn_parse(&p, doc, strlen(doc), tok, 16);
+    check(r == JSMN_SUCCESS && p.toknext == 9);
+    check(jsmn_object_get(doc, tok, p.toknext, 0, "id", 2, NULL) == 4);
+    check(jsmn_object_get(doc, tok, p.toknext, 0, "m", 1, NULL) == 8);
+    check(jsmn_object_get(doc, tok, p.toknext, 2, "id", 2, NULL) ==
+          JSMN_ERROR_INVAL);
+    check(jsmn_array_to_i64(doc, tok, p.toknext, 8, v, 4, &n) ==
+          JSMN_ERROR_INVAL);
+  }
+  return 0;
+}
+
+int test_end_offset(void) {
+  const char *js = "{\"a\": {\"b\": [1, \"x\"]}, \"c\": [], \"d\": true}";
+  jsmn_parser p;
+  jsmntok_t tok[16];
+  int r;
+
+  jsmn_init(&p);
+  r = jsmn_parse(&p, js, strlen(js), tok, 16);
+  check(r == JSMN_SUCCESS);
+  check(tok[0].end == strlen(js));
+  check(tok[2].end - tok[2].start == 15 &&
+        strncmp(js + tok[2].start, "{\"b\": [1, \"x\"]}", 15) == 0);
+  check(strncmp(js + tok[4].start, "[1, \"x\"]", tok[4].end - tok[4].start) == 0);
+  check(tok[6].end == tok[6].start + 1 && js[tok[6].end] == '\"');
+  check(tok[8].end - tok[8].start == 2 && tok[10].end == tok[10].start + 4);
+  return 0;
+}
+
+int test_pointer(void) {
+  const char *js = "{\"a\": {\"b\": [0, {\"x\": 1}, [2, 3], {\"c\": \"hit\"}]},"
+                   " \"m~n\": 4, \"a/b\": 5, \"\": 6, \"10\": {\"0\": 7}}";
+  const char *strs[] = {"", "/a/b/3/c", "/a/b/2/1", "/m~0n", "/a~1b",
+                        "/", "/10/0", "/a/b/4", "/a/b/01", "/a/x", "/a/b/-"};
+  const int want[] = {0, 14, 11, 16, 18, 20, 24, -1, -1, -1, -1};
+  jsmn_pointer ptrs[11];
+  jsmn_parser p;
+  jsmntok_t tok[32];
+  int out[11];
+  int i, r;
+
+  jsmn_init(&p);
+  r = jsmn_parse(&p, js, strlen(js), tok, 32);
+  check(r == JSMN_SUCCESS);
+  for (i = 0; i < 11; i++) {
+    check(jsmn_pointer_compile(&ptrs[i], strs[i], strlen(strs[i])) ==
+          JSMN_SUCCESS);
+    check(jsmn_pointer_get(js, tok, p.toknext, &ptrs[i]) == want[i]);
+  }
+  jsmn_pointer_get_many(js, tok, p.toknext, ptrs, 11, out);
+  for (i = 0; i < 11; i++)
+    check(out[i] == want[i]);
+
+  check(jsmn_pointer_compile(&ptrs[0], "a", 1) == JSMN_ERROR_INVAL);
+  check(jsmn_pointer_compile(&ptrs[0], "/a~2", 4) == JSMN_ERROR_INVAL);
+  check(jsmn_pointer_compile(&ptrs[0], "/a~", 3) == JSMN_ERROR_INVAL);
+  return 0;
+}
+
+int test_subs(void) {
+  const char *js = "{\"type\": \"order\", \"user\": {\"email\": \"a@b.c\", "
+                   "\"id\": 42}, \"items\": [{\"sku\": \"x-1\"}, {\"sku\": "
+                   "\"y-2\", \"qty\": 3}], \"region\": \"eu-we\\u0073t\"}";
+  jsmn_sub subs[] = {
+      {"type", JSMN_SUB_EQUALS, "order", 5, 0},
+      {"type", JSMN_SUB_EQUALS, "ord", 3, 0},
+      {"type", JSMN_SUB_PREFIX, "ord", 3, 0},
+      {"user.id", JSMN_SUB_EQUALS, "42", 2, 0},
+      {"user.id", JSMN_SUB_EQUALS, "4", 1, 0},
+      {"items[*].sku", JSMN_SUB_PREFIX, "y-", 2, 0},
+      {"items[*].qty", JSMN_SUB_EXISTS, NULL, 0, 0},
+      {"items[0].qty", JSMN_SUB_EXISTS, NULL, 0, 0},
+      {"region", JSMN_SUB_EQUALS, "eu-west", 7, 0},
+      {"region", JSMN_SUB_PREFIX, "eu-w", 4, 0},
+      {"missing", JSMN_SUB_EXISTS, NULL, 0, 0},
+      {"user", JSMN_SUB_EQUALS, "x", 1, 0},
+      {"items[0].sku", JSMN_SUB_EQUALS, "x-1", 3, 0},
+  };
+  jsmn_path_node nodes[16];
+  jsmn_path_edge edges[16];
+  jsmn_paths paths;
+  jsmn_sub bad = {"a..b", JSMN_SUB_EXISTS, NULL, 0, 0};
+  jsmn_parser p;
+  jsmntok_t tok[32];
+  uint32_t matched[1];
+  int r;
+
+  jsmn_init(&p);
+  r = jsmn_parse(&p, js, strlen(js), tok, 32);
+  check(r == JSMN_SUCCESS);
+  jsmn_paths_init(&paths, nodes, 16, edges, 16);
+  check(jsmn_subs_compile(&paths, subs, 13) == JSMN_SUCCESS);
+  /* Shared prefixes share nodes */
+  check(paths.nnodes == 13);
+  jsmn_subs_match(js, tok, p.toknext, &paths, subs, 13, matched);
+  check(matched[0] == 0x136d);
+
+  check(jsmn_subs_compile(&paths, &bad, 1) == JSMN_ERROR_INVAL);
+
+  /* Many filters on one field, escaped or not */
+  {
+    const char *docs[] = {"{\"t\": \"v042\"}", "{\"t\": \"\\u0076042\"}",
+                          "{\"t\": 42}"};
+    static const int hits[][6] = {{42, 104, 110, 111, 112, 113},
+                                  {42, 104, 110, 111, 112, 113},
+                                  {111, 113, -1, -1, -1, -1}};
+    static jsmn_sub many[115];
+    static char vals[110][5];
+    uint32_t want[4], got[4];
+    int i, d;
+
+    for (i = 0; i < 110; i++) {
+      (void)snprintf(vals[i], sizeof(vals[i]), i < 100 ? "v%03d" : "v%02d",
+                     i < 100 ? i : i - 100);
+      many[i].path = "t";
+      many[i].op = i < 100 ? JSMN_SUB_EQUALS : JSMN_SUB_PREFIX;
+      many[i].value = vals[i];
+      many[i].len = strlen(vals[i]);
+    }
+    for (; i < 115; i++) {
+      static const char *const v[] = {"v", "", "v042", NULL, "v0420"};
+      static const enum jsmn_sub_op op[] = {JSMN_SUB_PREFIX, JSMN_SUB_PREFIX,
+                                            JSMN_SUB_EQUALS, JSMN_SUB_EXISTS,
+                                            JSMN_SUB_PREFIX};
+      many[i].path = "t";
+      many[i].op = op[i - 110];
+      many[i].value = v[i - 110];
+      many[i].len = v[i - 110] != NULL ? strlen(v[i - 110]) : 0;
+    }
+    jsmn_paths_init(&paths, nodes, 16, edges, 16);
+    check(jsmn_subs_compile(&paths, many, 115) == JSMN_SUCCESS);
+    check(paths.nnodes == 2 && nodes[1].nsubs == 115);
+    for (d = 0; d < 3; d++) {
+      jsmn_init(&p);
+      r = jsmn_parse(&p, docs[d], strlen(docs[d]), tok, 32);
+      check(r == JSMN_SUCCESS);
+      memset(want, 0, sizeof(want));
+      for (i = 0; i < 6 && hits[d][i] >= 0; i++)
+        want[hits[d][i] / 32] |= (uint32_t)1 << (hits[d][i] % 32);
+      jsmn_subs_match(docs[d], tok, p.toknext, &paths, many, 115, got);
+      check(memcmp(want, got, sizeof(want)) == 0);
+    }
+  }
+  return 0;
+}
+
+int test_prefilter(void) {
+  const char *buf = "{\"level\":\"info\",\"msg\":\"started\"}\n"
+                    "{\"level\": \"error\", \"msg\": \"disk full\"}\n"
+                    "\n"
+                    "{\"level\":\"\\u0065rror\"}\n"
+                    "{\"level\":\"warn\",\"msg\":\"an error in msg\"}";
+  const char *all[] = {"\"level\"", "\"error\""};
+  const char *any[] = {"\"warn\"", "\"error\""};
+  jsmn_prefilter pf;
+  size_t pos = 0, start, end;
+
+  check(jsmn_prefilter_init(&pf, all, 2, false) == JSMN_SUCCESS);
+  check(jsmn_prefilter_next(&pf, buf, strlen(buf), &pos, &start, &end));
+  check(start == 33 && buf[end] == '\n' && buf[start + 11] == 'e');
+  /* The escaped spelling cannot be ruled out */
+  check(jsmn_prefilter_next(&pf, buf, strlen(buf), &pos, &start, &end));
+  check(start == 73 && end == 95);
+  check(!jsmn_prefilter_next(&pf, buf, strlen(buf), &pos, &start, &end));
+  check(pos == strlen(buf));
+
+  pos = 0;
+  check(jsmn_prefilter_init(&pf, any, 2, true) == JSMN_SUCCESS);
+  check(jsmn_prefilter_next(&pf, buf, strlen(buf), &pos, &start, &end));
+  check(start == 33);
+  check(jsmn_prefilter_next(&pf, buf, strlen(buf), &pos, &start, &end));
+  check(jsmn_prefilter_next(&pf, buf, strlen(buf), &pos, &start, &end));
+  check(start == 96 && end == strlen(buf));
+
+  check(jsmn_prefilter_init(&pf, (const char *[]){""}, 1, false) ==
+        JSMN_ERROR_INVAL);
+  return 0;
+}
+
+static int collect(void *ctx, const char *data, size_t len) {
+  char *s = ctx;
+  strncat(s, data, len);
+  return 0;
+}
+
+int test_rewrite(void) {
+  const char *js = "{\"user\": {\"email\": \"a\\u0040b.c\", \"id\": 7},"
+                   " \"ips\": [\"10.0.0.1\", \"10.0.0.2\"],"
+                   " \"card\": {\"no\": 4111, \"exp\": \"12/30\"}}";
+  const char *want = "{\"user\": {\"email\": \"***\", \"id\": 7},"
+                     " \"ips\": [\"10.0.0.1\", null],"
+                     " \"card\": {}}";
+  const char *kept = "{\"user\": {\"email\": \"***\", \"id\": 7},"
+                     " \"ips\": [\"10.0.0.1\", \"10.0.0.2\"],"
+                     " \"card\": {}}";
+  const jsmn_rewrite rules[] = {
+      {"user.email", "\"***\"", 5},
+      {"card", "{}", 2},
+      {"user.email", "\"\"", 2},
+      {"ips[1]", "null", 4},
+  };
+  jsmn_path_node nodes[8];
+  jsmn_path_edge edges[8];
+  jsmn_projection proj;
+  jsmn_paths paths;
+  jsmn_parser p;
+  jsmn_sink sink;
+  jsmntok_t tok[32];
+  char buf[16], out[128] = "", small[8];
+  int r;
+
+  jsmn_paths_init(&paths, nodes, 8, edges, 8);
+  check(jsmn_rewrite_compile(&paths, rules, 4) == JSMN_SUCCESS);
+
+  jsmn_init(&p);
+  r = jsmn_parse(&p, js, strlen(js), tok, 32);
+  check(r == JSMN_SUCCESS);
+  jsmn_sink_init(&sink, buf, sizeof(buf), collect, out);
+  check(jsmn_rewrite_run(js, strlen(js), tok, p.toknext, &paths, rules,
+                         &sink) == JSMN_SUCCESS);
+  check(jsmn_sink_flush(&sink) == JSMN_SUCCESS && sink.len == 0);
+  check(strcmp(out, want) == 0);
+
+  /* Tokens from a projection over the same key paths are enough */
+  out[0] = '\0';
+  jsmn_paths_init(&paths, nodes, 8, edges, 8);
+  check(jsmn_rewrite_compile(&paths, rules, 3) == JSMN_SUCCESS);
+  jsmn_init(&p);
+  jsmn_projection_init(&proj, &paths);
+  p.proj = &proj;
+  r = jsmn_parse(&p, js, strlen(js), tok, 32);
+  check(r == JSMN_SUCCESS && p.toknext == 11);
+  check(jsmn_rewrite_run(js, strlen(js), tok, p.toknext, &paths, rules,
+                         &sink) == JSMN_SUCCESS);
+  check(jsmn_sink_flush(&sink) == JSMN_SUCCESS);
+  check(strcmp(out, kept) == 0);
+
+  jsmn_sink_init(&sink, small, sizeof(small), NULL, NULL);
+  check(jsmn_rewrite_run(js, strlen(js), tok, p.toknext, &paths, rules,
+                         &sink) == JSMN_ERROR_NOMEM);
+  return 0;
+}
+
+int test_writer(void) {
+  const char *js = "{\"keep\": [1, {\"a\": \"x\\ty\"}], \"n\": 2}";
+  const char *want =
+      "{\"id\":-9223372036854775808,\"name\":\"a\\\"b\\\\c\\n\\u0001\","
+      "\"big\":18446744073709551615,\"f\":[0.1,-0,1e+21,123456789012345680000,"
+      "1.5e-7,5e-324,0.000001],\"ok\":true,\"none\":null,"
+      "\"keep\":[1, {\"a\": \"x\\ty\"}]}\n[]";
+  char buf[32], out[512] = "";
+  jsmn_parser p;
+  jsmntok_t tok[16];
+  jsmn_sink sink;
+  jsmn_writer w;
+  int r;
+
+  jsmn_init(&p);
+  r = jsmn_parse(&p, js, strlen(js), tok, 16);
+  check(r == JSMN_SUCCESS);
+
+  jsmn_sink_init(&sink, buf, sizeof(buf), collect, out);
+  jsmn_writer_init(&w, &sink);
+  jsmn_writer_begin_object(&w);
+  jsmn_writer_key(&w, "id", 2);
+  jsmn_writer_i64(&w, INT64_MIN);
+  jsmn_writer_key(&w, "name", 4);
+  jsmn_writer_string(&w, "a\"b\\c\n\001", 7);
+  jsmn_writer_key(&w, "big", 3);
+  jsmn_writer_u64(&w, UINT64_MAX);
+  jsmn_writer_key(&w, "f", 1);
+  jsmn_writer_begin_array(&w);
+  jsmn_writer_f64(&w, 0.1);
+  jsmn_writer_f64(&w, -0.0);
+  jsmn_writer_f64(&w, 1e21);
+  jsmn_writer_f64(&w, 123456789012345678901.0);
+  jsmn_writer_f64(&w, 1.5e-7);
+  jsmn_writer_f64(&w, 5e-324);
+  jsmn_writer_f64(&w, 1e-6);
+  jsmn_writer_end_array(&w);
+  jsmn_writer_key(&w, "ok", 2);
+  jsmn_writer_bool(&w, true);
+  jsmn_writer_key(&w, "none", 4);
+  jsmn_writer_null(&w);
+  jsmn_writer_token(&w, js, &tok[1]);
+  jsmn_writer_token(&w, js, &tok[2]);
+  jsmn_writer_end_object(&w);
+  jsmn_writer_begin_array(&w);
+  jsmn_writer_end_array(&w);
+  check(jsmn_writer_finish(&w) == JSMN_SUCCESS);
+  check(strcmp(out, want) == 0);
+
+  /* Misuse sticks */
+  jsmn_writer_init(&w, &sink);
+  jsmn_writer_begin_object(&w);
+  check(jsmn_writer_i64(&w, 1) == JSMN_ERROR_INVAL);
+  check(jsmn_writer_key(&w, "a", 1) == JSMN_ERROR_INVAL);
+  check(jsmn_writer_finish(&w) == JSMN_ERROR_INVAL);
+  jsmn_writer_init(&w, &sink);
+  jsmn_writer_begin_array(&w);
+  check(jsmn_writer_end_object(&w) == JSMN_ERROR_INVAL);
+  jsmn_writer_init(&w, &sink);
+  check(jsmn_writer_f64(&w, 1.0 / 0.0) == JSMN_ERROR_RANGE);
+  return 0;
+}
+
+static int roundtrip_f64(const double v) {
+  char buf[JSMN_FORMAT_MAX + 1];
+  jsmn_parser p;
+  jsmntok_t tok[1];
+  double r;
+  size_t n = jsmn_format_f64(buf, v);
+
+  /* A primitive needs a delimiter after it */
+  buf[n] = ' ';
+  jsmn_init(&p);
+  if (n == 0 || jsmn_parse(&p, buf, n + 1, tok, 1) != JSMN_SUCCESS ||
+      jsmn_get_f64(buf, &tok[0], &r) != JSMN_SUCCESS)
+    return 0;
+  return memcmp(&r, &v, sizeof(r)) == 0;
+}
+
+int test_format(void) {
+  char buf[JSMN_FORMAT_MAX];
+  uint64_t x = 88172645463325252ULL, bits;
+  double v;
+  int i;
+
+  check(jsmn_format_u64(buf, 0) == 1 && buf[0] == '0');
+  check(jsmn_format_u64(buf, UINT64_MAX) == 20 &&
+        strncmp(buf, "18446744073709551615", 20) == 0);
+  check(jsmn_format_i64(buf, INT64_MIN) == 20 &&
+        strncmp(buf, "-9223372036854775808", 20) == 0);
+  check(jsmn_format_i64(buf, -7) == 2 && strncmp(buf, "-7", 2) == 0);
+  check(jsmn_format_f64(buf, 5e-324) == 6 && strncmp(buf, "5e-324", 6) == 0);
+  check(jsmn_format_f64(buf, 1.7976931348623157e308) == 23 &&
+        strncmp(buf, "1.7976931348623157e+308", 23) == 0);
+  check(jsmn_format_f64(buf, 2.2250738585072014e-308) == 23);
+  check(jsmn_format_f64(buf, 100) == 3 && strncmp(buf, "100", 3) == 0);
+  check(jsmn_format_f64(buf, 0.3) == 3 && strncmp(buf, "0.3", 3) == 0);
+  check(jsmn_format_f64(buf, 1.0 / 0.0) == 0);
+
+  /* Powers of two and their neighbours, powers of ten, random bits */
+  for (i = 1; i < 2047; i++) {
+    bits = (uint64_t)i << 52;
+    memcpy(&v, &bits, sizeof(v));
+    check(roundtrip_f64(v));
+    bits--;
+    memcpy(&v, &bits, sizeof(v));
+    check(roundtrip_f64(v) && roundtrip_f64(-v));
+  }
+  for (i = -323; i < 309; i++) {
+    jsmn_parser p;
+    jsmntok_t tok[1];
+    int n = snprintf(buf, sizeof(buf), "1e%d ", i);
+    jsmn_init(&p);
+    check(jsmn_parse(&p, buf, n, tok, 1) == JSMN_SUCCESS &&
+          jsmn_get_f64(buf, &tok[0], &v) == JSMN_SUCCESS);
+    check(roundtrip_f64(v));
+  }
+  for (i = 0; i < 50000; i++) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    bits = i % 4 == 0 ? x & 0x800FFFFFFFFFFFFFULL : x;
+    memcpy(&v, &bits, sizeof(v));
+    if (v == v && v - v == 0)
+      check(roundtrip_f64(v));
+  }
+  return 0;
+}
+
+int test_reformat(void) {
+  char js[] = " {\"a\" : [1, 2.5e3,\n {} ], \"s\\\" \": \"x \\\\\" ,\t\"e\":[ ]}\n";
+  const char *min = "{\"a\":[1,2.5e3,{}],\"s\\\" \":\"x \\\\\",\"e\":[]}";
+  const char *pretty = "{\n"
+                       "\t\"a\": [\n"
+                       "\t\t1,\n"
+                       "\t\t2.5e3,\n"
+                       "\t\t{}\n"
+                       "\t],\n"
+                       "\t\"s\\\" \": \"x \\\\\",\n"
+                       "\t\"e\": []\n"
+                       "}"
+                       "[]\n7";
+  char buf[8], out[256] = "", copy[64];
+  size_t n;
+  jsmn_sink sink;
+
+  jsmn_sink_init(&sink, buf, sizeof(buf), collect, out);
+  check(jsmn_prettify(js, strlen(js), &sink, "\t") == JSMN_SUCCESS);
+  check(jsmn_prettify("[ ] 7", 5, &sink, "\t") == JSMN_SUCCESS);
+  check(jsmn_sink_flush(&sink) == JSMN_SUCCESS);
+  check(strcmp(out, pretty) == 0);
+
+  check(jsmn_minify(js, strlen(js), copy, &n) == JSMN_SUCCESS);
+  check(n == strlen(min) && strncmp(copy, min, n) == 0);
+  /* In place */
+  check(jsmn_minify(js, strlen(js), js, &n) == JSMN_SUCCESS);
+  check(n == strlen(min) && strncmp(js, min, n) == 0);
+
+  check(jsmn_count_tokens(min, strlen(min)) == 10);
+  strcpy(copy, "{\"a\\\"[\": -1e5, \"b\": true}");
+  check(jsmn_count_tokens(copy, strlen(copy)) == 5);
+
+  check(jsmn_minify("[\"a b", 5, copy, &n) == JSMN_ERROR_UNCLOSED_STRING);
+  check(n == 5 && strncmp(copy, "[\"a b", 5) == 0);
+  return 0;
+}
+
+int test_iov(void) {
+  const char *js = "{\"key\": [12345, -0.5e+3, true],\r\n \"s\\\"\\u00e9\": "
+                   "\"a b\\\\c\", \"n\": {\"x\": null}}";
+  const size_t len = strlen(js);
+  jsmntok_t ref[16], tok[16];
+  jsmn_iovec iov[3];
+  jsmn_parser p;
+  char scratch[64], out[128];
+  size_t i, j;
+  unsigned int k, n;
+
+  jsmn_init(&p);
+  check(jsmn_parse(&p, js, len, ref, 16) == JSMN_SUCCESS);
+  n = p.toknext;
+
+  /* Cut the document in three at every pair of positions */
+  for (i = 0; i <= len; i++) {
+    for (j = i; j <= len; j++) {
+      iov[0].base = js;
+      iov[0].len = i;
+      iov[1].base = js + i;
+      iov[1].len = j - i;
+      iov[2].base = js + j;
+      iov[2].len = len - j;
+      jsmn_init(&p);
+      check(jsmn_parse_iov(&p, iov, 3, tok, 16, scratch, sizeof(scratch)) ==
+            JSMN_SUCCESS);
+      check(p.toknext == n);
+      for (k = 0; k < n; k++) {
+        const char *s;
+        const size_t a = ref[k].start, b = ref[k].end;
+        const bool cut = (a < i && b > i) || (a < j && b > j);
+        check(tok[k].type == ref[k].type && tok[k].start == a &&
+              tok[k].end == b && tok[k].size == ref[k].size);
+        check(tok[k].split == (cut && tok[k].type > JSMN_ARRAY));
+        s = jsmn_iov_span(iov, 3, &tok[k], out, sizeof(out));
+        check(s != NULL && strncmp(s, js + a, b - a) == 0);
+        check(cut ? s == out : s != out);
+      }
+    }
+  }
+
+  /* A segment ending mid-document waits for more input */
+  iov[0].base = js;
+  iov[0].len = 10;
+  jsmn_init(&p);
+  check(jsmn_parse_iov(&p, iov, 1, tok, 16, scratch, sizeof(scratch)) ==
+        JSMN_ERROR_UNEXPECTED_EOF);
+  iov[1].base = js + 10;
+  iov[1].len = len - 10;
+  check(jsmn_parse_iov(&p, iov, 2, tok, 16, scratch, sizeof(scratch)) ==
+        JSMN_SUCCESS);
+  check(p.toknext == n);
+
+  /* A token longer than the scratch buffer cannot be bridged */
+  iov[0].len = 5;
+  iov[1].base = js + 5;
+  iov[1].len = len - 5;
+  jsmn_init(&p);
+  check(jsmn_parse_iov(&p, iov, 2, tok, 16, scratch, 3) == JSMN_ERROR_NOMEM);
+  iov[0].len = 4;
+  iov[1].base = js + 4;
+  iov[1].len = len - 4;
+  check(jsmn_iov_span(iov, 2, &ref[1], out, 2) == NULL);
+  check(jsmn_iov_span(iov, 2, &ref[1], out, 3) == out);
+  check(strncmp(out, "key", 3) == 0);
+
+  /* A stream of documents, each dropped once it is complete */
+  jsmn_init(&p);
+  p.flags = JSMN_STREAM;
+  check(jsmn_parse(&p, "{\"a\": 1} {\"b\": [2,", 18, tok, 16) ==
+        JSMN_SUCCESS);
+  check(p.toknext == 3 && p.pos == 8 && tok[0].end == 8);
+  check(jsmn_discard(&p, tok, 2, 8) == JSMN_ERROR_INVAL);
+  check(jsmn_discard(&p, tok, 3, 9) == JSMN_ERROR_INVAL);
+  check(jsmn_discard(&p, tok, 3, 8) == JSMN_SUCCESS);
+  check(p.toknext == 0 && p.pos == 0);
+  check(jsmn_parse(&p, " {\"b\": [2,", 10, tok, 16) ==
+        JSMN_ERROR_UNCLOSED_ARRAY);
+  check(jsmn_discard(&p, tok, 3, 1) == JSMN_ERROR_INVAL);
+  check(jsmn_discard(&p, tok, 0, 1) == JSMN_SUCCESS);
+  check(p.toknext == 4 && p.pos == 9 && tok[0].start == 0);
+  check(jsmn_parse(&p, "{\"b\": [2, 3]}", 13, tok, 16) == JSMN_SUCCESS);
+  check(p.toknext == 5 && tok[0].end == 13 && tok[2].size == 2);
+  check(tok[4].start == 10 && tok[4].size == 1);
+
+  /* Stream mode stops inside a segment */
+  iov[0].base = "{\"a\": [1]} {\"b";
+  iov[0].len = 14;
+  iov[1].base = "c\": 2}";
+  iov[1].len = 6;
+  jsmn_init(&p);
+  p.flags = JSMN_STREAM;
+  check(jsmn_parse_iov(&p, iov, 2, tok, 16, scratch, sizeof(scratch)) ==
+        JSMN_SUCCESS);
+  check(p.toknext == 4 && p.pos == 10);
+  check(jsmn_discard(&p, tok, 4, 10) == JSMN_SUCCESS);
+  iov[0].base = (const char *)iov[0].base + 10;
+  iov[0].len -= 10;
+  check(jsmn_parse_iov(&p, iov, 2, tok, 16, scratch, sizeof(scratch)) ==
+        JSMN_SUCCESS);
+  check(p.toknext == 3 && p.pos == 10 && tok[1].split && !tok[2].split);
+  return 0;
+}
+
+int test_budget(void) {
+  const char *js = "{\"a\": [1, 2, {\"b\": \"xyz\"}], \"c\": \"long string\", "
+                   "\"d\": {}}";
+  const size_t len = strlen(js);
+  jsmntok_t ref[16], tok[16];
+  jsmn_iovec iov[2];
+  jsmn_parser p;
+  char scratch[32];
+  unsigned int n, budget, calls;
+  int r;
+
+  jsmn_init(&p);
+  check(jsmn_parse(&p, js, len, ref, 16) == JSMN_SUCCESS);
+  n = p.toknext;
+
+  for (budget = 1; budget <= len; budget++) {
+    jsmn_init(&p);
+    p.budget = budget;
+    for (calls = 0; (r = jsmn_parse(&p, js, len, tok, 16)) == JSMN_YIELD;
+         calls++) {
+      check(calls < len);
+    }
+    check(r == JSMN_SUCCESS && p.toknext == n);
+    check(same_tokens(tok, ref, n) && tok[0].end == len && tok[2].end == 26);
+    check(budget > 1 || calls > 20);
+  }
+
+  jsmn_init(&p);
+  p.tokbudget = 2;
+  for (calls = 0; (r = jsmn_parse(&p, js, len, tok, 16)) == JSMN_YIELD;
+       calls++) {
+    check(p.toknext == 2 * (calls + 1));
+  }
+  check(r == JSMN_SUCCESS && calls == n / 2);
+  check(same_tokens(tok, ref, n));
+
+  /* Budgets span all segments of a scattered call */
+  iov[0].base = js;
+  iov[0].len = 20;
+  iov[1].base = js + 20;
+  iov[1].len = len - 20;
+  jsmn_init(&p);
+  p.budget = 4;
+  for (calls = 0; (r = jsmn_parse_iov(&p, iov, 2, tok, 16, scratch,
+                                      sizeof(scratch))) == JSMN_YIELD;
+       calls++) {
+  }
+  check(r == JSMN_SUCCESS && p.toknext == n && calls >= len / 16);
+  check(same_tokens(tok, ref, n));
+
+  /* Skipped and opaque values are scanned within the budget as well */
+  {
+    static char doc[8192];
+    const char *id[] = {"id"};
+    const char *blob[] = {"blob"};
+    jsmn_path_node nodes[4];
+    jsmn_path_edge edges[4];
+    jsmn_paths paths;
+    jsmn_projection proj;
+    jsmn_required req;
+    unsigned int mode, pos;
+    size_t k = 0;
+
+    k += sprintf(doc + k, "{\"blob\": {\"s\": \"");
+    while (k < 4000)
+      k += sprintf(doc + k, "ab\\\"]}");
+    k += sprintf(doc + k, "\", \"a\": [");
+    while (k < 8000)
+      k += sprintf(doc + k, "[1, {\"x\": \"}\"}],\n");
+    k += sprintf(doc + k, "0]}, \"id\": 1}");
+    jsmn_paths_init(&paths, nodes, 4, edges, 4);
+    check(jsmn_paths_compile(&paths, id, 1) == JSMN_SUCCESS);
+
+    for (mode = 0; mode < 2; mode++) {
+      jsmn_init(&p);
+      jsmn_projection_init(&proj, &paths);
+      p.proj = mode == 0 ? &proj : NULL;
+      p.shallow = mode;
+      p.budget = 64;
+      for (calls = 0, pos = 0;
+           (r = jsmn_parse(&p, doc, k, tok, 16)) == JSMN_YIELD; calls++) {
+        check(p.pos - pos <= 64 + 8);
+        pos = p.pos;
+      }
+      check(r == JSMN_SUCCESS && calls >= k / 64 - 1);
+      check(p.toknext == (mode == 0 ? 3 : 5) && p.line == 1 + 235);
+      check(jsmn_object_get(doc, tok, p.toknext, 0, "id", 2, NULL) ==
+            (int)p.toknext - 1);
+      check(mode == 0 ||
+            (tok[2].opaque && tok[2].end == (size_t)(strstr(doc, "]}, ") -
+                                                     doc) + 2));
+    }
+
+    /* A required value skipped across calls is found once it is done */
+    jsmn_init(&p);
+    jsmn_required_init(&req, blob, 1);
+    p.required = &req;
+    p.shallow = 1;
+    p.budget = 64;
+    while ((r = jsmn_parse(&p, doc, k, tok, 16)) == JSMN_YIELD) {
+    }
+    check(r == JSMN_EARLY_EXIT && p.toknext == 3 && tok[2].opaque);
+    check(tok[2].end == (size_t)(strstr(doc, "]}, ") - doc) + 2);
+  }
+  return 0;
+}
+
+int test_limits(void) {
+  static char deep[2001], longstr[4096];
+  const char *js = "{\"a\": [1, \"xyzw\", {}], \"b\": \"0123456789\"}";
+  const size_t len = strlen(js);
+  jsmntok_t tok[16];
+  jsmn_parser p;
+  int i;
+
+  /* Nesting: exactly at the limit passes, one more level fails there */
+  for (i = 0; i < 1000; i++) {
+    deep[i] = '[';
+    deep[2000 - 1 - i] = ']';
+  }
+  jsmn_init(&p);
+  p.max_depth = 3;
+  check(jsmn_parse(&p, "[[[]]]", 6, tok, 16) == JSMN_SUCCESS);
+  jsmn_init(&p);
+  p.max_depth = 3;
+  check(jsmn_parse(&p, deep, 2000, tok, 16) == JSMN_ERROR_TOO_DEEP);
+  check(p.pos == 3 && p.toknext == 3);
+
+  /* Strings: the raw length is limited, the scan stops at the limit */
+  jsmn_init(&p);
+  p.max_string = 10;
+  check(jsmn_parse(&p, js, len, tok, 16) == JSMN_SUCCESS);
+  jsmn_init(&p);
+  p.max_string = 9;
+  check(jsmn_parse(&p, js, len, tok, 16) == JSMN_ERROR_TOO_LONG);
+  check(p.pos == 28 && p.toknext == 7);
+  memset(longstr, 'x', sizeof(longstr));
+  longstr[0] = '\"';
+  jsmn_init(&p);
+  p.max_string = 100;
+  check(jsmn_parse(&p, longstr, sizeof(longstr), tok, 16) ==
+        JSMN_ERROR_TOO_LONG);
+  jsmn_init(&p);
+  check(jsmn_parse(&p, longstr, sizeof(longstr), tok, 16) ==
+        JSMN_ERROR_UNCLOSED_STRING);
+
+  /* Tokens: a limit below the array size is an error, not a retry */
+  jsmn_init(&p);
+  p.max_tokens = 8;
+  check(jsmn_parse(&p, js, len, tok, 16) == JSMN_SUCCESS);
+  jsmn_init(&p);
+  p.max_tokens = 7;
+  check(jsmn_parse(&p, js, len, tok, 16) == JSMN_ERROR_TOO_MANY_TOKENS);
+  check(p.toknext == 7);
+  jsmn_init(&p);
+  p.max_tokens = 7;
+  check(jsmn_parse(&p, js, len, tok, 4) == JSMN_ERROR_NOMEM);
+
+  /* Bytes: the input is never read past the limit */
+  jsmn_init(&p);
+  p.max_bytes = len;
+  check(jsmn_parse(&p, js, len, tok, 16) == JSMN_SUCCESS);
+  jsmn_init(&p);
+  p.max_bytes = len - 1;
+  check(jsmn_parse(&p, js, len, tok, 16) == JSMN_ERROR_TOO_BIG);
+  jsmn_init(&p);
+  p.max_bytes = 20;
+  check(jsmn_parse(&p, js, 9, tok, 16) == JSMN_ERROR_UNCLOSED_ARRAY);
+  check(jsmn_parse(&p, js, len, tok, 16) == JSMN_ERROR_TOO_BIG);
+  check(p.pos <= 20);
+  /* Whitespace after the document is not counted */
+  jsmn_init(&p);
+  p.max_bytes = 7;
+  check(jsmn_parse(&p, "{\"a\":1}\n", 8, tok, 16) == JSMN_SUCCESS);
+  check(p.toknext == 3 && p.pos == 8 && p.line == 2);
+  jsmn_init(&p);
+  p.max_bytes = 7;
+  check(jsmn_parse(&p, "{\"a\":1} x", 9, tok, 16) == JSMN_ERROR_TOO_BIG);
+  /* In a stream the limit applies to each document */
+  jsmn_init(&p);
+  p.flags = JSMN_STREAM;
+  p.max_bytes = 10;
+  check(jsmn_parse(&p, "{\"a\": 1} {\"b\": 2}", 17, tok, 16) ==
+        JSMN_SUCCESS);
+  check(jsmn_discard(&p, tok, p.toknext, p.pos) == JSMN_SUCCESS);
+  check(jsmn_parse(&p, " {\"b\": 2}", 9, tok, 16) == JSMN_SUCCESS);
+  check(p.toknext == 3);
+  return 0;
+}
+
+#ifdef JSMN_SYMTAB
+int test_symtab(void) {
+  enum { SYM_ID, SYM_NAME, SYM_TAGS };
+  jsmn_parser p;
+  jsmntok_t tok[16];
+  jsmn_sym slots[8];
+  char names[32];
+  jsmn_symtab st;
+  const char *js = "{\"id\": 1, \"na\\u006de\": \"x\", \"tags\": [], \"new\": 2}";
+  int r;
+
+  jsmn_symtab_init(&st, slots, 8, names, sizeof(names));
+  check(jsmn_symtab_add(&st, "id", 2) == SYM_ID);
+  check(jsmn_symtab_add(&st, "name", 4) == SYM_NAME);
+  check(jsmn_symtab_add(&st, "tags", 4) == SYM_TAGS);
+  check(jsmn_symtab_add(&st, "name", 4) == SYM_NAME);
+  check(jsmn_symtab_find(&st, "nam", 3) == JSMN_SYM_UNKNOWN);
+
+  jsmn_init(&p);
+  p.symtab = &st;
+  r = jsmn_parse(&p, js, strlen(js), tok, 16);
+  check(r == JSMN_SUCCESS);
+  check(tok[0].sym == JSMN_SYM_UNKNOWN);
+  check(tok[1].sym == SYM_ID && tok[2].sym == JSMN_SYM_UNKNOWN);
+  check(tok[3].sym == SYM_NAME && tok[4].sym == JSMN_SYM_UNKNOWN);
+  check(tok[5].sym == SYM_TAGS);
+  check(tok[7].sym == JSMN_SYM_UNKNOWN && st.count == 3);
+
+  /* Unknown keys are interned while parsing when add is set */
+  st.add = true;
+  jsmn_init(&p);
+  p.symtab = &st;
+  r = jsmn_parse(&p, js, strlen(js), tok, 16);
+  check(r == JSMN_SUCCESS);
+  check(tok[3].sym == SYM_NAME && tok[7].sym == 3);
+  check(jsmn_symtab_find(&st, "new", 3) == 3);
+
+  /* 3/4 of the slots at most */
+  check(jsmn_symtab_add(&st, "a", 1) == 4);
+  check(jsmn_symtab_add(&st, "b", 1) == 5);
+  check(jsmn_symtab_add(&st, "c", 1) == JSMN_SYM_UNKNOWN);
+  return 0;
+}
+#endif
+
 int main(void) {
   test(test_empty, "test for a empty JSON objects/arrays");
   test(test_object, "test for a JSON objects");
   test(test_array, "test for a JSON arrays");
   test(test_primitive, "test primitive JSON data types");
   test(test_string, "test string JSON data types");
+  test(test_string_escapes, "test escape flag of string tokens");
+  test(test_unescape, "test decoding of string tokens");
+  test(test_insitu, "test in-situ parsing");
+  test(test_utf8, "test UTF-8 validation of strings");
+  test(test_object_get, "test object key lookup");
+  test(test_shape_cache, "test key prediction from object shapes");
+  test(test_projection, "test path projection");
+  test(test_early_exit, "test early exit once required keys are found");
+  test(test_shallow, "test shallow parsing and expansion");
+  test(test_end_offset, "test end offsets of tokens");
+  test(test_pointer, "test JSON Pointer evaluation");
+  test(test_subs, "test subscription matching");
+  test(test_prefilter, "test raw-byte prefilter");
+  test(test_rewrite, "test rewriting values at paths");
+  test(test_writer, "test JSON writer");
+  test(test_format, "test number formatting round trips");
+  test(test_reformat, "test minify and prettify");
+  test(test_iov, "test scattered input");
+  test(test_budget, "test per call work budgets");
+  test(test_limits, "test document limits");
+#ifdef JSMN_SYMTAB
+  test(test_symtab, "test key symbol table");
+#endif
 
   test(test_partial_string, "test partial JSON string parsing");
   test(test_partial_array, "test partial array reading");
@@ -284,6 +1610,9 @@ int main(void) {
   test(test_object_key, "test for key type");
 
   test(test_bad_assignment, "test for malformed attribute assignment");
+  test(test_number_int, "test integer decoding of primitive tokens");
+  test(test_number_float, "test double decoding of primitive tokens");
+  test(test_number_array, "test bulk conversion of numeric arrays");
 
   printf("\nPASSED: %d\nFAILED: %d\n", test_passed, test_failed);
   return (test_failed > 0);